@@ -0,0 +1,923 @@
+//Benchmarks for Codable library
+//Usage: codable_bench [--suite] [--json results.json] [--compare baseline.json] [--threshold 0.1] [contacts count...]
+
+#include "Binary.hpp"
+#include "CBOR.hpp"
+#include "Codable.hpp"
+#include "FileIO.hpp"
+#include "generators.hpp"
+#include "JSON.hpp"
+#include "JSONFormat.hpp"
+#include "JSONLines.hpp"
+#include "JSONNumber.hpp"
+#include "JSONParallel.hpp"
+#include "JSONPlan.hpp"
+#include "JSONStream.hpp"
+#include "JSONString.hpp"
+#include "JSONStructural.hpp"
+#include "legacy_json.hpp"
+#include "models.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+//Count of memory allocations made by the whole program
+static atomic<unsigned long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations++;
+    void* pointer = malloc(size ? size : 1);
+    if (pointer == NULL) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t size) noexcept {
+    free(pointer);
+}
+
+//Measuring average time of one run in milliseconds
+template <typename F>
+double measure(F function, int runs) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        function();
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count() / runs;
+}
+
+void report(const char* name, unsigned long bytes, double milliseconds) {
+    printf("  %-32s %10.3f ms %10.1f MB/s\n", name, milliseconds, bytes / (milliseconds * 1000.0));
+}
+
+//Sink that drops encoded text
+class NullSink: public CoderSink {
+public:
+    void write(const char* data, unsigned long length) {}
+};
+
+void benchPhoneBook(unsigned long count) {
+    PhoneBook book = makePhoneBook(count);
+    JSONEncoder encoder;
+    auto encodeContainer = encoder.container();
+    encodeContainer.encode(book);
+    const string& content = encodeContainer.content;
+    int runs = count > 10000 ? 1 : 5;
+
+    printf("phone book with %lu contacts (%lu bytes)\n", count, (unsigned long)content.size());
+
+    report("encode PhoneBook", content.size(), measure([&]() {
+        JSONEncoder encoder;
+        auto container = encoder.container();
+        container.encode(book);
+    }, runs));
+    StaticPhoneBook staticBook = makeStaticPhoneBook(count);
+    report("encode PhoneBook (fields list)", content.size(), measure([&]() {
+        JSONEncoder encoder;
+        auto container = encoder.container();
+        container.encode(staticBook);
+    }, runs));
+    report("encode PhoneBook to sink", content.size(), measure([&]() {
+        NullSink sink;
+        JSONEncoder encoder;
+        auto container = encoder.container(&sink);
+        container.encode(book);
+    }, runs));
+
+    //Legacy algorithm is quadratic, so it is skipped for big documents
+    if (count <= 20000) {
+        report("decode tree (split, before)", content.size(), measure([&]() {
+            vector<LegacyJSONNode> nodes;
+            legacyParse("", content, &nodes);
+        }, runs));
+    }
+    //Finding of structural characters only, with every supported implementation
+    const JSONScanLevel levels[] = { JSONScanLevel::scalar, JSONScanLevel::sse2, JSONScanLevel::avx2 };
+    const char* levelNames[] = { "structural scan (scalar)", "structural scan (sse2)", "structural scan (avx2)" };
+    vector<unsigned> tape(content.size());
+    for (int i = 0; i < 3; i++) {
+        if (!jsonScanLevelSupported(levels[i])) {
+            continue;
+        }
+        JSONStructuralScanner scanner(levels[i]);
+        report(levelNames[i], content.size(), measure([&]() {
+            scanner.begin();
+            scanner.scan(content.data(), content.size(), tape.data());
+        }, runs));
+    }
+    report("decode tree (single-pass)", content.size(), measure([&]() {
+        JSONDecoder decoder;
+        decoder.container(content);
+    }, runs));
+    JSONDecoder reusedDecoder;
+    report("decode tree (reused decoder)", content.size(), measure([&]() {
+        reusedDecoder.container(content);
+        reusedDecoder.reset();
+    }, runs));
+    report("decode PhoneBook", content.size(), measure([&]() {
+        JSONDecoder decoder;
+        auto container = decoder.container(content);
+        container.decode(PhoneBook());
+    }, runs));
+    report("decode PhoneBook (fields list)", content.size(), measure([&]() {
+        JSONDecoder decoder;
+        auto container = decoder.container(content);
+        container.decode(StaticPhoneBook());
+    }, runs));
+}
+
+//Binary format compared with JSON: size of documents and speed of encoding and decoding
+void benchBinary(unsigned long count) {
+    PhoneBook book = makePhoneBook(count);
+    JSONEncoder jsonEncoder;
+    auto jsonContainer = jsonEncoder.container();
+    jsonContainer.encode(book);
+    BinaryEncoder binaryEncoder;
+    auto binaryContainer = binaryEncoder.container();
+    binaryContainer.encode(book);
+    const string& json = jsonContainer.content;
+    const string& binary = binaryContainer.content;
+    int runs = count > 10000 ? 1 : 5;
+
+    printf("binary phone book with %lu contacts (%lu bytes, %.1f%% of JSON)\n", count, (unsigned long)binary.size(), 100.0 * binary.size() / json.size());
+    //Speed is reported for size of JSON document, so numbers are comparable
+    report("encode JSON", json.size(), measure([&]() {
+        jsonContainer.encode(book);
+    }, runs));
+    report("encode binary", json.size(), measure([&]() {
+        binaryContainer.encode(book);
+    }, runs));
+    JSONDecoder jsonDecoder;
+    report("decode JSON", json.size(), measure([&]() {
+        auto container = jsonDecoder.container(json);
+        container.decode(PhoneBook());
+        jsonDecoder.reset();
+    }, runs));
+    BinaryDecoder binaryDecoder;
+    report("decode binary", json.size(), measure([&]() {
+        auto container = binaryDecoder.container(binary);
+        container.decode(PhoneBook());
+        binaryDecoder.reset();
+    }, runs));
+}
+
+//Comparing size and speed of all the formats on the same classes with list of fields
+void benchFormats(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count), decoded;
+    JSONEncodeContainer jsonContainer = JSONEncoder().container();
+    jsonContainer.encode(book);
+    BinaryEncodeContainer binaryContainer = BinaryEncoder().container();
+    binaryContainer.encode(book);
+    CBOREncodeContainer cborContainer = CBOREncoder().container();
+    cborContainer.encode(book);
+    const string& json = jsonContainer.content;
+    const string& binary = binaryContainer.content;
+    const string& cbor = cborContainer.content;
+    int runs = count > 10000 ? 1 : 5;
+
+    printf("formats with %lu contacts (JSON %lu bytes, binary %.1f%%, CBOR %.1f%% of JSON)\n", count, (unsigned long)json.size(),
+        100.0 * binary.size() / json.size(), 100.0 * cbor.size() / json.size());
+    //Speed is reported for size of JSON document, so numbers are comparable
+    report("encode JSON", json.size(), measure([&]() {
+        jsonContainer.encode(book);
+    }, runs));
+    report("encode binary", json.size(), measure([&]() {
+        binaryContainer.encode(book);
+    }, runs));
+    report("encode CBOR", json.size(), measure([&]() {
+        cborContainer.encode(book);
+    }, runs));
+    JSONDecoder jsonDecoder;
+    report("decode JSON", json.size(), measure([&]() {
+        auto container = jsonDecoder.container(json);
+        container.decodeTo(decoded);
+        jsonDecoder.reset();
+    }, runs));
+    BinaryDecoder binaryDecoder;
+    report("decode binary", json.size(), measure([&]() {
+        auto container = binaryDecoder.container(binary);
+        container.decodeTo(decoded);
+        binaryDecoder.reset();
+    }, runs));
+    CBORDecoder cborDecoder;
+    report("decode CBOR", json.size(), measure([&]() {
+        auto container = cborDecoder.container(cbor);
+        container.decodeTo(decoded);
+        cborDecoder.reset();
+    }, runs));
+}
+
+//Decoding array of contacts that arrives by chunks of 16 KB, compared with decoding of the whole text
+void benchStream(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count);
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(book.contacts);
+    const string& text = container.content;
+    const unsigned long chunkSize = 1 << 14;
+    int runs = count > 10000 ? 1 : 5;
+    vector<StaticContact> contacts;
+    unsigned long received = 0;
+
+    printf("stream of %lu contacts by chunks of %lu bytes\n", count, chunkSize);
+    JSONDecoder decoder;
+    report("decode whole text", text.size(), measure([&]() {
+        auto whole = decoder.container(text);
+        whole.decodeTo(contacts);
+        decoder.reset();
+    }, runs));
+    JSONStreamDecoder<StaticContact> stream([&](StaticContact& contact) {
+        received++;
+    });
+    report("decode by chunks", text.size(), measure([&]() {
+        for (unsigned long start = 0; start < text.size(); start += chunkSize) {
+            stream.feed(text.data() + start, min(chunkSize, text.size() - start));
+        }
+        stream.finish();
+    }, runs));
+    //Range of elements of array that isn't expanded by parser
+    JSONEncodeContainer bookContainer = JSONEncoder().container();
+    bookContainer.encode(book);
+    JSONDecoder shallowDecoder;
+    shallowDecoder.setMaxDepth(1);
+    report("decode elements one by one", bookContainer.content.size(), measure([&]() {
+        auto shallow = shallowDecoder.container(bookContainer.content);
+        for (const StaticContact& contact : shallow.elements<StaticContact>("contacts")) {
+            received += contact.is_valid;
+        }
+        shallowDecoder.reset();
+    }, runs));
+}
+
+void reportRecords(const char* name, unsigned long records, double milliseconds) {
+    printf("  %-32s %10.3f ms %10.0f records/s\n", name, milliseconds, records / (milliseconds / 1000.0));
+}
+
+//Encoding and decoding contacts as newline-delimited JSON
+void benchLines(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count);
+    JSONEncodeContainer container = JSONEncoder().container();
+    int runs = count > 10000 ? 1 : 5;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+
+    auto encodeLines = [&]() {
+        container.reset();
+        for (const StaticContact& contact : book.contacts) {
+            container.encodeLine(contact);
+        }
+    };
+    encodeLines();
+    const string& text = container.content;
+    printf("lines with %lu contacts (%lu bytes)\n", count, (unsigned long)text.size());
+    reportRecords("encode lines", count, measure(encodeLines, runs));
+    vector<StaticContact> contacts;
+    //Old way: new decoder and new buffer for every line
+    reportRecords("decoder per line", count, measure([&]() {
+        istringstream stream(text);
+        string line;
+        contacts.clear();
+        while (getline(stream, line)) {
+            JSONDecoder decoder;
+            contacts.push_back(decoder.container(line).decode(StaticContact()));
+        }
+    }, runs));
+    JSONLinesDecoder decoder;
+    reportRecords("decode lines", count, measure([&]() {
+        decoder.decode(text.data(), text.size(), contacts);
+    }, runs));
+    unsigned long valid = 0;
+    reportRecords("decode lines one by one", count, measure([&]() {
+        decoder.decodeEach<StaticContact>(text.data(), text.size(), [&](StaticContact& contact) {
+            valid += contact.is_valid;
+        });
+    }, runs));
+    JSONLinesDecoder parallelDecoder(threads);
+    char name[64];
+    snprintf(name, sizeof(name), "decode lines by %u threads", threads);
+    reportRecords(name, count, measure([&]() {
+        parallelDecoder.decode(text.data(), text.size(), contacts);
+    }, runs));
+}
+
+//Encoding and decoding array of contacts by pools of 1..N threads
+//Decoding is measured for parsed array and for array that isn't expanded by parser
+void benchParallel(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count);
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(book);
+    const string& text = container.content;
+    int runs = count > 10000 ? 1 : 5;
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    vector<StaticContact> contacts;
+
+    printf("parallel coding of %lu contacts\n", count);
+    JSONEncodeContainer output = JSONEncoder().container();
+    report("encode, serial", text.size(), measure([&]() {
+        output.encode(book.contacts);
+    }, runs));
+    JSONDecoder decoder;
+    JSONDecoder shallowDecoder;
+    shallowDecoder.setMaxDepth(1);
+    char name[64];
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        CodableThreadPool pool(threads);
+        JSONParallelDecoder parallel(&pool);
+        JSONParallelEncoder encoder(&pool);
+        snprintf(name, sizeof(name), "encode, %u threads", threads);
+        report(name, text.size(), measure([&]() {
+            encoder.encode(output, book.contacts);
+        }, runs));
+        snprintf(name, sizeof(name), "parse + decode, %u threads", threads);
+        report(name, text.size(), measure([&]() {
+            auto parsed = decoder.container(text);
+            parallel.decodeTo(parsed, contacts, "contacts");
+            decoder.reset();
+        }, runs));
+        snprintf(name, sizeof(name), "parallel parse, %u threads", threads);
+        report(name, text.size(), measure([&]() {
+            auto shallow = shallowDecoder.container(text);
+            parallel.decodeTo(shallow, contacts, "contacts");
+            shallowDecoder.reset();
+        }, runs));
+    }
+}
+
+//Writing phone book to file through sink and decoding it from file read to string and from mapped file
+void benchFiles(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count), decoded;
+    const char* path = "codable_bench.json";
+    int runs = count > 10000 ? 1 : 5;
+    unsigned long size = 0;
+
+    auto encodeToFile = [&]() {
+        FILE* file = fopen(path, "wb");
+        CodableFileSink sink(fileno(file));
+        JSONEncodeContainer container = JSONEncoder().container(&sink);
+        container.encode(book);
+        sink.flush();
+        size = ftell(file);
+        fclose(file);
+    };
+    encodeToFile();
+    printf("file with %lu contacts (%lu bytes)\n", count, size);
+    report("encode to file descriptor", size, measure(encodeToFile, runs));
+    JSONDecoder decoder;
+    report("decode file read to string", size, measure([&]() {
+        ifstream file(path, ios::binary);
+        string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        decoder.container(move(text)).decodeTo(decoded);
+        decoder.reset();
+    }, runs));
+    report("decode mapped file", size, measure([&]() {
+        decoder.containerFromFile(path).decodeTo(decoded);
+        decoder.reset();
+    }, runs));
+    remove(path);
+}
+
+//Reading few fields of big document with eager and lazy decoding
+void benchLazy(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count);
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(book);
+    const string& text = container.content;
+    int runs = count > 10000 ? 1 : 5;
+    string name;
+
+    printf("few fields of phone book with %lu contacts\n", count);
+    JSONDecoder decoder;
+    JSONDecoder lazyDecoder;
+    lazyDecoder.setLazy(true);
+    auto readFields = [&](JSONDecoder& decoder) {
+        JSONDecodeContainer document = decoder.container(text.data(), text.size());
+        JSONDecodeContainer* contacts = document["contacts"];
+        contacts->expand();
+        contacts->children[contacts->childrenCount / 2]->decodeTo(name, "name");
+        decoder.reset();
+    };
+    report("eager", text.size(), measure([&]() {
+        readFields(decoder);
+    }, runs));
+    report("lazy", text.size(), measure([&]() {
+        readFields(lazyDecoder);
+    }, runs));
+}
+
+//Decoding phone book by generic decoder and directly with decode plans (the same models as in test/test.cpp)
+void benchPlan(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count), decoded;
+    PhoneBook protocolBook;
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(book);
+    const string& text = container.content;
+    int runs = count > 10000 ? 1 : 5;
+
+    printf("decode plans for phone book with %lu contacts\n", count);
+    JSONDecoder decoder;
+    report("generic decoder (fields list)", text.size(), measure([&]() {
+        decoder.container(text.data(), text.size()).decodeTo(decoded);
+        decoder.reset();
+    }, runs));
+    JSONPlanDecoder planDecoder;
+    report("decode plan (fields list)", text.size(), measure([&]() {
+        planDecoder.decode(text, decoded);
+    }, runs));
+    //Classes with Codable protocol have no plans, they are decoded by generic decoder from their texts
+    report("decode plan (Codable protocol)", text.size(), measure([&]() {
+        planDecoder.decode(text, protocolBook);
+    }, runs));
+}
+
+//Escaping and unescaping of plain ASCII text and of text with escapes and UTF-8, compared with copying
+void benchStrings() {
+    string mixed;
+    for (const string& text : generateStrings(5000).texts) {
+        mixed += text;
+    }
+    string plain(mixed.size(), 'a');
+    string escapedMixed;
+    jsonEscape(mixed.data(), mixed.size(), escapedMixed);
+    string output;
+    int runs = 20;
+
+    printf("strings of %lu characters\n", mixed.size());
+    report("copy", plain.size(), measure([&]() {
+        output.assign(plain);
+    }, runs));
+    report("escape (plain text)", plain.size(), measure([&]() {
+        output.clear();
+        jsonEscape(plain.data(), plain.size(), output);
+    }, runs));
+    report("unescape (plain text)", plain.size(), measure([&]() {
+        output.clear();
+        jsonUnescape(plain.data(), plain.size(), output);
+    }, runs));
+    report("escape (escapes and UTF-8)", mixed.size(), measure([&]() {
+        output.clear();
+        jsonEscape(mixed.data(), mixed.size(), output);
+    }, runs));
+    report("unescape (escapes and UTF-8)", escapedMixed.size(), measure([&]() {
+        output.clear();
+        jsonUnescape(escapedMixed.data(), escapedMixed.size(), output);
+    }, runs));
+}
+
+//Encoding in standard, compact and pretty formats and reformatting of encoded text
+void benchTextFormats(unsigned long count) {
+    StaticPhoneBook book = makeStaticPhoneBook(count);
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(book);
+    const string& text = container.content;
+    string output;
+    int runs = count > 10000 ? 1 : 5;
+
+    printf("text formats of phone book with %lu contacts\n", count);
+    const char* names[] = { "standard", "compact", "pretty" };
+    JSONFormatStyle styles[] = { JSONFormatStyle::standard, JSONFormatStyle::compact, JSONFormatStyle::pretty };
+    for (int i = 0; i < 3; i++) {
+        JSONEncodeContainer formatted = JSONEncoder(JSONFormat(styles[i], 2)).container();
+        formatted.encode(book);
+        unsigned long size = formatted.content.size();
+        report((string("encode ") + names[i]).c_str(), size, measure([&]() {
+            formatted.encode(book);
+        }, runs));
+        report((string("reformat to ") + names[i]).c_str(), text.size(), measure([&]() {
+            output.clear();
+            jsonReformat(text.data(), text.size(), JSONFormat(styles[i], 2), output);
+        }, runs));
+        printf("  %-32s %10lu bytes\n", names[i], size);
+    }
+}
+
+//Decoding every field of closure with many fields in the same and in reverse order
+void benchWideClosure(int fields) {
+    vector<string> keys;
+    string content = "{";
+    for (int i = 0; i < fields; i++) {
+        keys.push_back("field_" + to_string(i));
+        content += (i ? ",\"" : "\"") + keys.back() + "\": " + to_string(i);
+    }
+    content += "}";
+
+    JSONDecoder decoder;
+    auto container = decoder.container(content);
+    int runs = 1000;
+    long long sum = 0;
+
+    printf("closure with %d fields\n", fields);
+    double inOrder = measure([&]() {
+        for (int i = 0; i < fields; i++) {
+            sum += container.decode(int(), keys[i]);
+        }
+    }, runs);
+    double reversed = measure([&]() {
+        for (int i = fields - 1; i >= 0; i--) {
+            sum += container.decode(int(), keys[i]);
+        }
+    }, runs);
+    printf("  %-32s %10.3f us\n", "decode all fields in order", inOrder * 1000);
+    printf("  %-32s %10.3f us\n", "decode all fields reversed", reversed * 1000);
+    if (sum == 42) {
+        printf("\n");
+    }
+}
+
+//Number conversions compared with stringstream that was used before
+void benchNumbers() {
+    const int count = 200000;
+    mt19937_64 random(1);
+    vector<double> doubles;
+    vector<long long> integers;
+    vector<string> doubleTexts, integerTexts;
+    for (int i = 0; i < count; i++) {
+        doubles.push_back((double)(random() % 100000000) / (1 + random() % 10000));
+        integers.push_back((long long)(random() % 10000000000LL) - 5000000000LL);
+        char buffer[JSONNumberBufferSize];
+        doubleTexts.push_back(string(buffer, jsonWriteDouble(doubles.back(), buffer)));
+        integerTexts.push_back(string(buffer, jsonWriteInteger(integers.back(), buffer)));
+    }
+    unsigned long checksum = 0;
+
+    printf("%d numbers\n", count);
+    double old = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            stringstream ss;
+            ss << doubles[i];
+            checksum += ss.str().length();
+        }
+    }, 1);
+    double current = measure([&]() {
+        char buffer[JSONNumberBufferSize];
+        for (int i = 0; i < count; i++) {
+            checksum += jsonWriteDouble(doubles[i], buffer);
+        }
+    }, 1);
+    printf("  %-32s %10.1f ns %10.1f ns (stringstream, 6 digits)\n", "write double", current * 1e6 / count, old * 1e6 / count);
+
+    old = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            stringstream ss;
+            ss << doubleTexts[i];
+            double value;
+            ss >> value;
+            checksum += (unsigned long)value;
+        }
+    }, 1);
+    current = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            double value;
+            jsonParseDouble(doubleTexts[i].data(), doubleTexts[i].length(), value);
+            checksum += (unsigned long)value;
+        }
+    }, 1);
+    printf("  %-32s %10.1f ns %10.1f ns (stringstream)\n", "parse double", current * 1e6 / count, old * 1e6 / count);
+
+    old = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            stringstream ss;
+            ss << integers[i];
+            checksum += ss.str().length();
+        }
+    }, 1);
+    current = measure([&]() {
+        char buffer[JSONNumberBufferSize];
+        for (int i = 0; i < count; i++) {
+            checksum += jsonWriteInteger(integers[i], buffer);
+        }
+    }, 1);
+    printf("  %-32s %10.1f ns %10.1f ns (stringstream)\n", "write integer", current * 1e6 / count, old * 1e6 / count);
+
+    old = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            stringstream ss;
+            ss << integerTexts[i];
+            long long value;
+            ss >> value;
+            checksum += value;
+        }
+    }, 1);
+    current = measure([&]() {
+        for (int i = 0; i < count; i++) {
+            long long value;
+            jsonParseInteger(integerTexts[i].data(), integerTexts[i].length(), value);
+            checksum += value;
+        }
+    }, 1);
+    printf("  %-32s %10.1f ns %10.1f ns (stringstream)\n", "parse integer", current * 1e6 / count, old * 1e6 / count);
+    if (checksum == 42) {
+        printf("\n");
+    }
+}
+
+//Allocations and time per message when the same small message is handled in a loop (like in RPC server)
+template <typename F>
+void reportMessages(const char* name, int messages, F function) {
+    unsigned long before = allocations;
+    double milliseconds = measure(function, messages);
+    double perMessage = (double)(allocations - before) / messages;
+    printf("  %-32s %10.1f allocations %10.3f us\n", name, perMessage, milliseconds * 1000);
+}
+
+void benchMessageLoop() {
+    const int messages = 10000;
+    PhoneBook book = makePhoneBook(10);
+    JSONEncoder encoder;
+    auto reusedEncodeContainer = encoder.container();
+    reusedEncodeContainer.encode(book);
+    string content = reusedEncodeContainer.content;
+    JSONDecoder reusedDecoder;
+
+    printf("message loop (%lu bytes per message)\n", (unsigned long)content.size());
+    reportMessages("encode with new container", messages, [&]() {
+        auto container = encoder.container();
+        container.encode(book);
+    });
+    reportMessages("encode with reused container", messages, [&]() {
+        reusedEncodeContainer.encode(book);
+    });
+    reportMessages("decode tree with new decoder", messages, [&]() {
+        JSONDecoder decoder;
+        decoder.container(content);
+    });
+    reportMessages("decode tree with reused decoder", messages, [&]() {
+        reusedDecoder.container(content);
+        reusedDecoder.reset();
+    });
+    reportMessages("decode PhoneBook, reused decoder", messages, [&]() {
+        auto container = reusedDecoder.container(content);
+        container.decode(PhoneBook());
+        reusedDecoder.reset();
+    });
+    //Virtual decode methods of PhoneBook return new vector, the same book with list of fields is decoded in place
+    StaticPhoneBook decodedBook;
+    reportMessages("decode fields list in place", messages, [&]() {
+        auto container = reusedDecoder.container(content);
+        container.decodeTo(decodedBook);
+        reusedDecoder.reset();
+    });
+}
+
+//Result of benchmark of one document shape
+//Consists of:
+// name - name of shape
+// bytes - size of encoded document
+// encode_mbps, decode_mbps, plan_decode_mbps - throughput of encoding, generic decoding and decoding with plans
+// encode_allocations, decode_allocations, plan_decode_allocations - allocations per document when objects are reused
+class BenchResult {
+public:
+    string name;
+    long long bytes = 0;
+    double encode_mbps = 0;
+    double decode_mbps = 0;
+    double plan_decode_mbps = 0;
+    long long encode_allocations = 0;
+    long long decode_allocations = 0;
+    long long plan_decode_allocations = 0;
+
+    CODABLE_FIELDS(BenchResult, name, bytes, encode_mbps, decode_mbps, plan_decode_mbps, encode_allocations,
+        decode_allocations, plan_decode_allocations)
+};
+
+//Results of benchmark suite, they are written as JSON to compare them across commits
+//Consists of:
+// results - results of every shape
+// peak_rss_kb - peak resident set size of process in KB (0 if it is unknown)
+class BenchReport {
+public:
+    vector<BenchResult> results;
+    long long peak_rss_kb = 0;
+
+    CODABLE_FIELDS(BenchReport, results, peak_rss_kb)
+};
+
+//Peak resident set size of process in KB
+long long peakRSS() {
+#if defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+#elif defined(__unix__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+//Throughput of function in MB/s, function is repeated for at least 0.3 s (and at least 3 times) after warm-up run
+template <typename F>
+double throughput(unsigned long bytes, F function) {
+    function();
+    int runs = 0;
+    auto start = chrono::steady_clock::now();
+    double seconds = 0;
+    while (runs < 3 || seconds < 0.3) {
+        function();
+        runs++;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    return bytes * runs / seconds / 1e6;
+}
+
+//Count of allocations made by one call of function
+template <typename F>
+long long countAllocations(F function) {
+    unsigned long before = allocations;
+    function();
+    return (long long)(allocations - before);
+}
+
+//Encoding and decoding document of one shape with reused container and decoders
+template <class T>
+BenchResult benchShape(const char* name, const T& value) {
+    BenchResult result;
+    result.name = name;
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(value);
+    const string text = container.content;
+    result.bytes = text.size();
+
+    auto encode = [&]() {
+        container.encode(value);
+    };
+    result.encode_mbps = throughput(text.size(), encode);
+    result.encode_allocations = countAllocations(encode);
+
+    JSONDecoder decoder;
+    T decoded;
+    auto decode = [&]() {
+        decoder.container(text.data(), text.size()).decodeTo(decoded);
+        decoder.reset();
+    };
+    result.decode_mbps = throughput(text.size(), decode);
+    result.decode_allocations = countAllocations(decode);
+
+    JSONPlanDecoder planDecoder;
+    auto planDecode = [&]() {
+        planDecoder.decode(text, decoded);
+    };
+    result.plan_decode_mbps = throughput(text.size(), planDecode);
+    result.plan_decode_allocations = countAllocations(planDecode);
+
+    printf("  %-18s %9.1f KB  encode %8.1f MB/s  decode %8.1f MB/s  plan %8.1f MB/s  allocations %lld/%lld/%lld\n",
+        name, text.size() / 1024.0, result.encode_mbps, result.decode_mbps, result.plan_decode_mbps,
+        result.encode_allocations, result.decode_allocations, result.plan_decode_allocations);
+    return result;
+}
+
+//Running benchmarks of all shapes of documents
+BenchReport benchSuite() {
+    BenchReport report;
+    printf("suite of document shapes\n");
+    report.results.push_back(benchShape("wide", generateWide(2000)));
+    report.results.push_back(benchShape("deep", generateDeep(2000, 50)));
+    report.results.push_back(benchShape("arrays", generateArrays(200000)));
+    report.results.push_back(benchShape("numbers", generateNumbers(100000)));
+    report.results.push_back(benchShape("strings", generateStrings(20000)));
+    report.results.push_back(benchShape("phone_book", makePhoneBook(20000)));
+    report.results.push_back(benchShape("static_phone_book", makeStaticPhoneBook(20000)));
+    report.peak_rss_kb = peakRSS();
+    printf("  peak RSS %lld KB\n", report.peak_rss_kb);
+    return report;
+}
+
+//Comparing results with baseline, returns count of regressions
+//Throughput that is lower by more than threshold and any new allocations are regressions
+int compareReports(const BenchReport& baseline, const BenchReport& current, double threshold) {
+    int regressions = 0;
+    printf("comparison with baseline (threshold %.0f%%)\n", threshold * 100);
+    for (const BenchResult& result : current.results) {
+        for (const BenchResult& base : baseline.results) {
+            if (base.name != result.name) {
+                continue;
+            }
+            const double values[] = { result.encode_mbps, result.decode_mbps, result.plan_decode_mbps };
+            const double baseValues[] = { base.encode_mbps, base.decode_mbps, base.plan_decode_mbps };
+            const long long counts[] = { result.encode_allocations, result.decode_allocations, result.plan_decode_allocations };
+            const long long baseCounts[] = { base.encode_allocations, base.decode_allocations, base.plan_decode_allocations };
+            const char* names[] = { "encode", "decode", "plan" };
+            for (int i = 0; i < 3; i++) {
+                double ratio = baseValues[i] > 0 ? values[i] / baseValues[i] : 1;
+                bool slower = ratio < 1 - threshold, allocates = counts[i] > baseCounts[i];
+                regressions += slower || allocates;
+                printf("  %-18s %-6s %+7.1f%%  allocations %lld -> %lld%s\n", result.name.c_str(), names[i], (ratio - 1) * 100,
+                    baseCounts[i], counts[i], slower || allocates ? "  REGRESSION" : "");
+            }
+        }
+    }
+    return regressions;
+}
+
+//Running all detailed benchmarks for phone books of specific sizes
+void benchAll(const vector<unsigned long>& counts) {
+    for (unsigned long count : counts) {
+        benchPhoneBook(count);
+    }
+    for (unsigned long count : counts) {
+        benchBinary(count);
+    }
+    for (unsigned long count : counts) {
+        benchFormats(count);
+    }
+    for (unsigned long count : counts) {
+        benchTextFormats(count);
+    }
+    for (unsigned long count : counts) {
+        benchStream(count);
+    }
+    for (unsigned long count : counts) {
+        benchLines(count);
+    }
+    for (unsigned long count : counts) {
+        benchParallel(count);
+    }
+    for (unsigned long count : counts) {
+        benchFiles(count);
+    }
+    for (unsigned long count : counts) {
+        benchLazy(count);
+    }
+    for (unsigned long count : counts) {
+        benchPlan(count);
+    }
+    benchNumbers();
+    benchStrings();
+    benchWideClosure(16);
+    benchWideClosure(256);
+    benchMessageLoop();
+}
+
+int main(int argc, char** argv) {
+    vector<unsigned long> counts;
+    bool suiteOnly = false;
+    const char* jsonPath = NULL;
+    const char* baselinePath = NULL;
+    double threshold = 0.1;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--suite") {
+            suiteOnly = true;
+        } else if (argument == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (argument == "--compare" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (argument == "--threshold" && i + 1 < argc) {
+            threshold = strtod(argv[++i], NULL);
+        } else {
+            counts.push_back(strtoul(argv[i], NULL, 10));
+        }
+    }
+    if (counts.empty()) {
+        counts = { 100, 1000, 10000, 100000 };
+    }
+    if (!suiteOnly) {
+        benchAll(counts);
+    }
+
+    BenchReport report = benchSuite();
+    if (jsonPath != NULL) {
+        FILE* file = fopen(jsonPath, "wb");
+        if (file == NULL) {
+            fprintf(stderr, "can't write %s\n", jsonPath);
+            return 1;
+        }
+        {
+            CodableFileSink sink(fileno(file));
+            JSONEncodeContainer container = JSONEncoder().container(&sink);
+            container.encode(report);
+        }
+        fclose(file);
+    }
+    if (baselinePath != NULL) {
+        BenchReport baseline;
+        CodableMappedFile file;
+        if (!file.open(baselinePath) || !JSONPlanDecoder().decode(file.data, file.length, baseline)) {
+            fprintf(stderr, "can't read baseline %s\n", baselinePath);
+            return 1;
+        }
+        if (compareReports(baseline, report, threshold) > 0) {
+            return 2;
+        }
+    }
+    return 0;
+}
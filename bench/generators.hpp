@@ -0,0 +1,170 @@
+//Generators of synthetic documents for benchmark suite
+//Every shape is a class with list of fields, so it is encoded and decoded by the same code as user classes.
+
+#ifndef BENCH_GENERATORS_H
+#define BENCH_GENERATORS_H
+
+#include "Codable.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+//Closure with many fields of different types
+class WideRecord {
+public:
+    int i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15;
+    long long l0, l1, l2, l3, l4, l5, l6, l7, l8, l9, l10, l11, l12, l13, l14, l15;
+    double d0, d1, d2, d3, d4, d5, d6, d7, d8, d9, d10, d11, d12, d13, d14, d15;
+    std::string s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15;
+
+    CODABLE_FIELDS(WideRecord, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15,
+        l0, l1, l2, l3, l4, l5, l6, l7, l8, l9, l10, l11, l12, l13, l14, l15,
+        d0, d1, d2, d3, d4, d5, d6, d7, d8, d9, d10, d11, d12, d13, d14, d15,
+        s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15)
+};
+
+class WideDocument {
+public:
+    std::vector<WideRecord> records;
+
+    CODABLE_FIELDS(WideDocument, records)
+};
+
+//Tree node, chains of nodes make deeply nested documents
+class DeepNode {
+public:
+    int value;
+    std::string label;
+    std::vector<DeepNode> children;
+
+    CODABLE_FIELDS(DeepNode, value, label, children)
+};
+
+class DeepDocument {
+public:
+    std::vector<DeepNode> chains;
+
+    CODABLE_FIELDS(DeepDocument, chains)
+};
+
+//Long arrays of small values
+class ArrayDocument {
+public:
+    std::vector<int> ids;
+    std::vector<long long> times;
+    std::vector<std::string> codes;
+
+    CODABLE_FIELDS(ArrayDocument, ids, times, codes)
+};
+
+//Numbers of all kinds (integers, fractions, exponents, negative values)
+class NumberDocument {
+public:
+    std::vector<double> values;
+    std::vector<long long> counters;
+    std::vector<float> levels;
+
+    CODABLE_FIELDS(NumberDocument, values, counters, levels)
+};
+
+//Long strings with characters that are escaped in JSON text (quotes, backslashes, control characters) and UTF-8
+class StringDocument {
+public:
+    std::vector<std::string> texts;
+
+    CODABLE_FIELDS(StringDocument, texts)
+};
+
+//Random string of letters, digits and spaces
+inline std::string generateText(std::mt19937& random, unsigned long length) {
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789    ";
+    std::string text(length, ' ');
+    for (unsigned long i = 0; i < length; i++) {
+        text[i] = letters[random() % (sizeof(letters) - 1)];
+    }
+    return text;
+}
+
+inline WideDocument generateWide(unsigned long count) {
+    std::mt19937 random(1);
+    WideDocument document;
+    document.records.resize(count);
+    for (WideRecord& record : document.records) {
+        int* ints[] = { &record.i0, &record.i1, &record.i2, &record.i3, &record.i4, &record.i5, &record.i6, &record.i7,
+            &record.i8, &record.i9, &record.i10, &record.i11, &record.i12, &record.i13, &record.i14, &record.i15 };
+        long long* longs[] = { &record.l0, &record.l1, &record.l2, &record.l3, &record.l4, &record.l5, &record.l6, &record.l7,
+            &record.l8, &record.l9, &record.l10, &record.l11, &record.l12, &record.l13, &record.l14, &record.l15 };
+        double* doubles[] = { &record.d0, &record.d1, &record.d2, &record.d3, &record.d4, &record.d5, &record.d6, &record.d7,
+            &record.d8, &record.d9, &record.d10, &record.d11, &record.d12, &record.d13, &record.d14, &record.d15 };
+        std::string* strings[] = { &record.s0, &record.s1, &record.s2, &record.s3, &record.s4, &record.s5, &record.s6, &record.s7,
+            &record.s8, &record.s9, &record.s10, &record.s11, &record.s12, &record.s13, &record.s14, &record.s15 };
+        for (int i = 0; i < 16; i++) {
+            *ints[i] = (int)(random() % 100000);
+            *longs[i] = (long long)random() * 1000003LL;
+            *doubles[i] = (random() % 1000000) / 1000.0;
+            *strings[i] = generateText(random, 4 + random() % 12);
+        }
+    }
+    return document;
+}
+
+inline DeepDocument generateDeep(unsigned long count, int depth) {
+    std::mt19937 random(2);
+    DeepDocument document;
+    document.chains.resize(count);
+    for (DeepNode& chain : document.chains) {
+        DeepNode* node = &chain;
+        for (int level = 0; level < depth; level++) {
+            node->value = level;
+            node->label = generateText(random, 3 + random() % 5);
+            node->children.resize(1);
+            node = &node->children[0];
+        }
+        node->value = depth;
+        node->label = "leaf";
+    }
+    return document;
+}
+
+inline ArrayDocument generateArrays(unsigned long count) {
+    std::mt19937 random(3);
+    ArrayDocument document;
+    for (unsigned long i = 0; i < count; i++) {
+        document.ids.push_back((int)(random() % 1000000));
+        document.times.push_back(1700000000000LL + (long long)(random() % 100000000));
+        document.codes.push_back(generateText(random, 2 + random() % 4));
+    }
+    return document;
+}
+
+inline NumberDocument generateNumbers(unsigned long count) {
+    std::mt19937_64 random(4);
+    std::uniform_real_distribution<double> fractions(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> exponents(-300.0, 300.0);
+    NumberDocument document;
+    for (unsigned long i = 0; i < count; i++) {
+        document.values.push_back(i % 4 == 0 ? std::pow(10.0, exponents(random)) : fractions(random));
+        document.counters.push_back((long long)(random() >> (random() % 60)) * (i % 2 ? 1 : -1));
+        document.levels.push_back((float)fractions(random) / 7.0f);
+    }
+    return document;
+}
+
+inline StringDocument generateStrings(unsigned long count) {
+    static const char* escapes[] = { "\"", "\\", "\n", "\t", "\xc3\xa9", "/" };
+    std::mt19937 random(5);
+    StringDocument document;
+    for (unsigned long i = 0; i < count; i++) {
+        std::string text;
+        unsigned long length = 40 + random() % 200;
+        while (text.size() < length) {
+            text += generateText(random, 1 + random() % 24);
+            text += escapes[random() % 6];
+        }
+        document.texts.push_back(text);
+    }
+    return document;
+}
+
+#endif
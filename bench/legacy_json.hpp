@@ -0,0 +1,100 @@
+//Baseline JSON decoding algorithm kept for before/after comparison in benchmarks
+//It is a copy of decoding containers constructor that was used before single-pass parser:
+//content is debeautified, split by commas and colons and every child is parsed recursively from its own copy.
+
+#ifndef LEGACY_JSON_H
+#define LEGACY_JSON_H
+
+#include <string>
+#include <vector>
+
+//Decoded node of legacy algorithm
+//Consists of:
+// key - name of node
+// content - text of node without brackets
+// childrenIndexes - indexes of children in nodes array
+struct LegacyJSONNode {
+    std::string key;
+    std::string content;
+    std::vector<unsigned long> childrenIndexes;
+};
+
+inline void legacyJsonDebeautify(std::string& content) {
+    bool isInValue = false;
+    for (int i = 0; i < content.length(); i++) {
+        if (content[i] == '\"') {
+            isInValue = !isInValue;
+        }
+        if ((content[i] == ' ' || content[i] == '\n') && !isInValue) {
+            content.erase(content.begin() + i--);
+        }
+    }
+}
+
+inline std::vector<std::string> legacySplit(std::string content, char splitter, bool onlyGlobal = false, bool onlyNonValue = false) {
+    std::vector<std::string> result;
+    int firstIndex = 0, level = 0;
+    bool isInValue = false;
+
+    for (int i = 0; i < content.length(); i++) {
+        if (content[i] == '{' || content[i] == '[') {
+            level++;
+        }
+        if (content[i] == '}' || content[i] == ']') {
+            level--;
+        }
+        if (content[i] == '\"') {
+            isInValue = !isInValue;
+        }
+        if ((!level || !onlyGlobal) && (!isInValue || !onlyNonValue)) {
+            if (content[i] == splitter) {
+                if (i - firstIndex) {
+                    result.push_back(content.substr(firstIndex, i - firstIndex));
+                }
+                firstIndex = i + 1;
+            }
+        }
+    }
+    if (content.length() - firstIndex) {
+        result.push_back(content.substr(firstIndex, content.length() - firstIndex));
+    }
+    return result;
+}
+
+inline LegacyJSONNode legacyParse(std::string key, std::string content, std::vector<LegacyJSONNode>* nodes) {
+    LegacyJSONNode node;
+    node.key = key;
+    legacyJsonDebeautify(content);
+    if (content.length() < 2) {
+        node.content = content;
+        return node;
+    }
+    if (content[0] != '{' && content[0] != '[') {
+        node.content = content;
+        return node;
+    }
+    content.erase(content.begin());
+    content.erase(content.end() - 1);
+    node.content = content;
+
+    auto splitted = legacySplit(content, ',', true, true);
+    for (int i = 0; i < splitted.size(); i++) {
+        auto keyval = legacySplit(splitted[i], ':', true, true);
+        std::string childKey = "";
+        std::string childContent = "";
+        if (keyval.size() > 1 && keyval[0].size() > 1) {
+            keyval[0].erase(keyval[0].begin());
+            keyval[0].erase(keyval[0].end() - 1);
+            childKey = keyval[0];
+            childContent = keyval[1];
+        }
+        else {
+            childContent = keyval[0];
+        }
+        nodes->push_back(legacyParse(childKey, childContent, nodes));
+        node.childrenIndexes.push_back(nodes->size() - 1);
+    }
+    return node;
+}
+
+#endif
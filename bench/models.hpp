@@ -0,0 +1,199 @@
+//Models used in benchmarks
+//They are the same as phone book models in test/test.cpp
+
+#ifndef BENCH_MODELS_H
+#define BENCH_MODELS_H
+
+#include "Binary.hpp"
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include <string>
+#include <vector>
+
+class PhoneNumber: public Codable {
+public:
+    int country_code;
+    long long number;
+    float last_signal_level;
+
+    void encode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONEncodeContainer* jsonContainer = dynamic_cast<JSONEncodeContainer*>(container);
+
+            jsonContainer->encode(country_code, "country");
+            jsonContainer->encode(number, "number");
+            jsonContainer->encode(last_signal_level, "signal");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(country_code, "country");
+            binaryContainer->encode(number, "number");
+            binaryContainer->encode(last_signal_level, "signal");
+        }
+    }
+
+    void decode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONDecodeContainer* jsonContainer = dynamic_cast<JSONDecodeContainer*>(container);
+
+            this->country_code = jsonContainer->decode(int(), "country");
+            this->number = jsonContainer->decode(0LL, "number");
+            this->last_signal_level = jsonContainer->decode(float(), "signal");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer* binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            this->country_code = binaryContainer->decode(int(), "country");
+            this->number = binaryContainer->decode(0LL, "number");
+            this->last_signal_level = binaryContainer->decode(float(), "signal");
+        }
+    }
+
+    PhoneNumber() {}
+
+    PhoneNumber(int country_code, long long number, float last_signal_level) {
+        this->country_code = country_code;
+        this->number = number;
+        this->last_signal_level = last_signal_level;
+    }
+};
+
+class Contact: public Codable {
+public:
+    std::string name;
+    PhoneNumber phone_number;
+    bool is_valid;
+
+    void encode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONEncodeContainer* jsonContainer = dynamic_cast<JSONEncodeContainer*>(container);
+
+            jsonContainer->encode(name, "name");
+            jsonContainer->encode(phone_number, "phone_number");
+            jsonContainer->encode(is_valid, "is_valid");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(name, "name");
+            binaryContainer->encode(phone_number, "phone_number");
+            binaryContainer->encode(is_valid, "is_valid");
+        }
+    }
+
+    void decode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONDecodeContainer* jsonContainer = dynamic_cast<JSONDecodeContainer*>(container);
+
+            name = jsonContainer->decode(std::string(), "name");
+            phone_number = jsonContainer->decode(PhoneNumber(), "phone_number");
+            is_valid = jsonContainer->decode(bool(), "is_valid");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer* binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            name = binaryContainer->decode(std::string(), "name");
+            phone_number = binaryContainer->decode(PhoneNumber(), "phone_number");
+            is_valid = binaryContainer->decode(bool(), "is_valid");
+        }
+    }
+
+    Contact() {}
+
+    Contact(std::string name, PhoneNumber phone_number, bool is_valid) {
+        this->name = name;
+        this->phone_number = phone_number;
+        this->is_valid = is_valid;
+    }
+};
+
+class PhoneBook: public Codable {
+public:
+    std::vector<Contact> contacts;
+    double time_spent;
+
+    void encode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONEncodeContainer* jsonContainer = dynamic_cast<JSONEncodeContainer*>(container);
+
+            jsonContainer->encode(contacts, "contacts");
+            jsonContainer->encode(time_spent, "time_spent");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(contacts, "contacts");
+            binaryContainer->encode(time_spent, "time_spent");
+        }
+    }
+
+    void decode(CoderContainer* container) {
+        if (container->type == CoderType::json) {
+            JSONDecodeContainer* jsonContainer = dynamic_cast<JSONDecodeContainer*>(container);
+
+            contacts = jsonContainer->decode(std::vector<Contact>(), "contacts");
+            time_spent = jsonContainer->decode(double(), "time_spent");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer* binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            contacts = binaryContainer->decode(std::vector<Contact>(), "contacts");
+            time_spent = binaryContainer->decode(double(), "time_spent");
+        }
+    }
+
+    PhoneBook() {}
+
+    PhoneBook(std::vector<Contact> contacts, double time_spent) {
+        this->contacts = contacts;
+        this->time_spent = time_spent;
+    }
+};
+
+//Generating phone book with specific count of contacts
+inline PhoneBook makePhoneBook(unsigned long count) {
+    std::vector<Contact> contacts;
+    for (unsigned long i = 0; i < count; i++) {
+        contacts.push_back(Contact("Contact " + std::to_string(i), PhoneNumber(i % 1000, 1000000 + i, (i % 100) / 7.0f), i % 3 != 0));
+    }
+    return PhoneBook(contacts, 3.14159265358979);
+}
+
+//The same models with lists of fields (encoded to the same text)
+class StaticPhoneNumber {
+public:
+    int country;
+    long long number;
+    float signal;
+
+    CODABLE_FIELDS(StaticPhoneNumber, country, number, signal)
+};
+
+class StaticContact {
+public:
+    std::string name;
+    StaticPhoneNumber phone_number;
+    bool is_valid;
+
+    CODABLE_FIELDS(StaticContact, name, phone_number, is_valid)
+};
+
+class StaticPhoneBook {
+public:
+    std::vector<StaticContact> contacts;
+    double time_spent;
+
+    CODABLE_FIELDS(StaticPhoneBook, contacts, time_spent)
+};
+
+inline StaticPhoneBook makeStaticPhoneBook(unsigned long count) {
+    StaticPhoneBook book;
+    for (unsigned long i = 0; i < count; i++) {
+        StaticContact contact;
+        contact.name = "Contact " + std::to_string(i);
+        contact.phone_number.country = i % 1000;
+        contact.phone_number.number = 1000000 + i;
+        contact.phone_number.signal = (i % 100) / 7.0f;
+        contact.is_valid = i % 3 != 0;
+        book.contacts.push_back(contact);
+    }
+    book.time_spent = 3.14159265358979;
+    return book;
+}
+
+#endif
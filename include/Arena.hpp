@@ -0,0 +1,74 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <mutex>
+#include <vector>
+
+//Monotonic memory arena
+//Memory is taken from big blocks and is never freed separately. Whole arena is released at once with reset(),
+//which keeps blocks for reuse, so repeated work of the same size doesn't allocate memory at all.
+//Objects created in arena must not need destructors.
+//Consists of:
+// blocks - allocated blocks of memory
+// current - index of block that is used now (-1 if there are no blocks yet)
+// position - count of used bytes in current block
+// blockSize - minimal size of new block
+// sharedMutex - lock of allocations that are made by several threads (see allocateShared)
+class Arena {
+public:
+    Arena(unsigned long blockSize = 64 * 1024);
+    ~Arena();
+
+    //Allocating memory with specific alignment (power of two, not bigger than 16)
+    void* allocate(unsigned long size, unsigned long alignment = sizeof(void*)) {
+        if (current >= 0) {
+            unsigned long start = (position + alignment - 1) & ~(alignment - 1);
+            if (start + size <= blocks[current].size) {
+                position = start + size;
+                return blocks[current].data + start;
+            }
+        }
+        return allocateInNextBlock(size, alignment);
+    }
+
+    //Allocating array of objects that don't need construction (or will be constructed with placement new)
+    template <typename T>
+    T* allocate(unsigned long count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    //Allocating array from one of several threads that use arena at the same time, only these allocations are
+    //synchronized, so other allocations must not be made by them then (threads of other arenas are never blocked)
+    template <typename T>
+    T* allocateShared(unsigned long count) {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        return allocate<T>(count);
+    }
+
+    //Releasing all the memory in O(1), blocks are kept for reuse
+    void reset();
+    //Freeing all the blocks
+    void release();
+
+    //Total size of blocks
+    unsigned long capacity() const;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+private:
+    struct Block {
+        char* data;
+        unsigned long size;
+    };
+
+    std::vector<Block> blocks;
+    long current;
+    unsigned long position;
+    unsigned long blockSize;
+    std::mutex sharedMutex;
+
+    void* allocateInNextBlock(unsigned long size, unsigned long alignment);
+};
+
+#endif
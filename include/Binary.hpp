@@ -0,0 +1,417 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+#include "Codable.hpp"
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//Compact binary format for services that share the same classes
+//Values are written one after another in encoding order, keys are not written, so fields must be decoded
+//in the same order as they were encoded. Format of values:
+// bool - one byte (0 or 1)
+// int, long long and other signed integers - zigzag varint (7 bits per byte, little-endian order of groups)
+// unsigned integers - varint, enums - their underlying integers
+// float, double - raw IEEE 754 bytes in little-endian order
+// string - varint length and bytes
+// vector, std::array, std::deque - varint count of elements and elements
+// map - varint count of entries and pairs of string key and value
+// optional value - bool of presence and value if it is present
+// closure - 4-byte little-endian length in bytes and fields (closures up to 4 GiB, longer ones aren't written)
+//Length of closure lets decoder skip fields that are unknown to it, fields that are missing at the end of closure
+//are decoded as default values, so fields can be added to the end of classes without breaking old messages.
+
+//Container for encoding to binary format
+//Like JSON containers, every container appends data directly to the output of the whole document.
+//Consists of:
+// content - encoded data (filled by containers created by encoder, unless sink is provided)
+// root - the highest container that keeps output (NULL for the highest container itself)
+// sink - destination where output is flushed to by pieces (NULL if data is kept in content)
+// openClosures - count of closures with not written length (output can't be flushed until it is zero)
+// closureLimit - maximal length of closure in bytes (4 GiB, or smaller limit of the highest container)
+// overflowed - true if some closure of the document is longer than limit (the rest of document isn't written)
+class BinaryEncodeContainer: public CoderContainer {
+public:
+    std::string content;
+
+    //Encoding std::vector as array
+    template <typename T>
+    void encode(const std::vector<T>& value, CodingKey key) {
+        writeArray(value);
+    }
+
+    //Encoding methods for standard data types, keys are ignored
+
+    void encode(bool value, CodingKey key = CodingKey());
+    void encode(int value, CodingKey key = CodingKey());
+    void encode(long long value, CodingKey key = CodingKey());
+    void encode(unsigned long long value, CodingKey key = CodingKey());
+    void encode(float value, CodingKey key = CodingKey());
+    void encode(double value, CodingKey key = CodingKey());
+    void encode(const std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, unsigned long length, CodingKey key, bool withQuotes = true);
+
+    //Encoding method for classes with Codable protocol or list of fields and for other types by their kinds
+    //(integers, enums, sequences, maps and optional values, see CodableTraits.hpp)
+    template <class T>
+    void encode(const T& value, CodingKey key) {
+        encodeValue(value, CodableKindTag<T>());
+    }
+
+    //Encoding method for value of any type without key
+    template <class T>
+    void encode(const T& value) {
+        begin();
+        encodeValue(value, CodableKindTag<T>());
+        end();
+    }
+
+    //Encoding std::vector as array without key
+    template <typename T>
+    void encode(const std::vector<T>& value) {
+        begin();
+        writeArray(value);
+        end();
+    }
+
+    //Clearing encoded data of the highest container, its capacity is kept for the next document
+    void reset();
+    //Limiting length of closures of documents (bigger limits are reduced to 4 GiB, length of closure takes 4 bytes)
+    void setClosureLimit(unsigned long long limit);
+
+    //Checking if the last document isn't written because of closure longer than limit
+    //Content of such document is cleared and nothing is flushed to sink after the long closure
+    bool failed() const {
+        return overflowed;
+    }
+
+    BinaryEncodeContainer();
+    BinaryEncodeContainer(CoderSink* sink);
+
+private:
+    BinaryEncodeContainer* root;
+    CoderSink* sink;
+    unsigned long openClosures;
+    unsigned long long closureLimit;
+    bool overflowed;
+
+    //Constructor for nested closures, they write to output of the highest container
+    BinaryEncodeContainer(BinaryEncodeContainer* parent);
+
+    //Getting data of the document
+    std::string& data() {
+        return root != NULL ? root->content : content;
+    }
+
+    BinaryEncodeContainer* top() {
+        return root != NULL ? root : this;
+    }
+
+    void begin();
+    //Finishing the highest value of the document, returns false if document isn't written because of long closure
+    bool end();
+    //Flushing output to sink when it becomes big enough and all the closures are finished
+    void flush(bool force = false);
+    void writeVarint(unsigned long long value);
+    //Reserving space for length of closure, returns position of length
+    unsigned long openClosure();
+    void closeClosure(unsigned long position);
+
+    //Encoding of values by kinds of their types
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::object>) {
+        static_assert(CodableHasFields<T>::value || std::is_polymorphic<T>::value, "Type has neither list of fields nor Codable protocol");
+        writeClosure(value);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::integer>) {
+        encode((typename CodableInteger<T>::Wide)value);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::enumeration>) {
+        typedef typename std::underlying_type<T>::type Underlying;
+        encode((typename CodableInteger<Underlying>::Wide)value);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::sequence>) {
+        writeArray(value);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::map>) {
+        writeVarint(value.size());
+        for (const auto& entry : value) {
+            encode(entry.first);
+            encode(entry.second, CodingKey());
+            flush();
+        }
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodableKindConstant<CodableKind::optional>) {
+        bool present = CodableOptional<T>::hasValue(value);
+        encode(present);
+        if (present) {
+            encode(CodableOptional<T>::value(value), CodingKey());
+        }
+    }
+
+    template <class T>
+    void writeClosure(const T& value) {
+        unsigned long position = openClosure();
+        BinaryEncodeContainer closure(this);
+        //Encode methods and visitors take non-const objects, but they don't modify them
+        writeFields(const_cast<T&>(value), &closure, std::integral_constant<bool, CodableHasFields<T>::value>());
+        closeClosure(position);
+    }
+
+    //Encoding fields of class with list of fields (static dispatch)
+    template <class T>
+    void writeFields(T& value, BinaryEncodeContainer* closure, std::true_type) {
+        CodableFieldEncoder<BinaryEncodeContainer> visitor = { closure };
+        codableVisit(value, visitor);
+    }
+
+    //Encoding fields of class with Codable protocol (virtual call)
+    template <class T>
+    void writeFields(T& value, BinaryEncodeContainer* closure, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->encode(closure);
+        }
+    }
+
+    //Writing std::vector or other sequence as array
+    template <typename S>
+    void writeArray(const S& value) {
+        writeVarint(value.size());
+        for (const auto& element : value) {
+            encode(element, CodingKey());
+            flush();
+        }
+    }
+};
+
+//Container for decoding from binary format
+//Container reads values one after another from source buffer which is kept alive by decoder.
+//Consists of:
+// source - pointer to source buffer
+// position - position of the next value
+// end - position after the last byte of container
+class BinaryDecodeContainer: public CoderContainer {
+public:
+    const char* source;
+    unsigned long position;
+    unsigned long end;
+
+    //Checking if all the values of container are decoded
+    bool atEnd() const {
+        return position >= end;
+    }
+
+    //Decoding methods that fill existing value, they return false and keep value if container has no more values
+    //or value is malformed, keys are ignored
+
+    bool decodeTo(bool& value, CodingKey key = CodingKey());
+    bool decodeTo(int& value, CodingKey key = CodingKey());
+    bool decodeTo(long long& value, CodingKey key = CodingKey());
+    bool decodeTo(unsigned long long& value, CodingKey key = CodingKey());
+    bool decodeTo(float& value, CodingKey key = CodingKey());
+    bool decodeTo(double& value, CodingKey key = CodingKey());
+    bool decodeTo(std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+
+    template <typename T>
+    bool decodeTo(std::vector<T>& value, CodingKey key = CodingKey()) {
+        unsigned long long count;
+        //Every element takes at least one byte, so bigger count means malformed data
+        if (!readVarint(count) || count > end - position) {
+            return false;
+        }
+        value.clear();
+        value.resize(count);
+        for (unsigned long i = 0; i < count; i++) {
+            decodeTo(value[i]);
+        }
+        return true;
+    }
+
+    //Elements of std::vector<bool> are bits that can't be decoded in place, so they are decoded through deque
+    bool decodeTo(std::vector<bool>& value, CodingKey key = CodingKey()) {
+        std::deque<bool> elements;
+        if (!decodeTo(elements, key)) {
+            return false;
+        }
+        value.assign(elements.begin(), elements.end());
+        return true;
+    }
+
+    //Decoding of classes with Codable protocol or list of fields and of other types by their kinds (see CodableTraits.hpp)
+    template <class T>
+    bool decodeTo(T& value, CodingKey key = CodingKey()) {
+        return decodeValue(value, CodableKindTag<T>());
+    }
+
+    //Decoding methods that return value, provided sample is returned if container has no more values
+
+    bool decode(bool type, CodingKey key);
+    int decode(int type, CodingKey key);
+    long long decode(long long type, CodingKey key);
+    float decode(float type, CodingKey key);
+    double decode(double type, CodingKey key);
+    std::string decode(std::string type, CodingKey key, bool withQuotes = true);
+
+    template <class T>
+    T decode(T type, CodingKey key) {
+        decodeTo(type, key);
+        return type;
+    }
+
+    template<typename T>
+    T decode(T type) {
+        decodeTo(type);
+        return type;
+    }
+
+    BinaryDecodeContainer(const char* source, unsigned long position, unsigned long end);
+
+private:
+    bool readVarint(unsigned long long& value);
+
+    //Decoding of values by kinds of their types
+
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::object>) {
+        BinaryDecodeContainer closure(source, 0, 0);
+        if (!readClosure(closure)) {
+            return false;
+        }
+        closure.readFields(value, std::integral_constant<bool, CodableHasFields<T>::value>());
+        return true;
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::integer>) {
+        typename CodableInteger<T>::Wide wide;
+        return decodeTo(wide) && CodableInteger<T>::narrow(wide, value);
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::enumeration>) {
+        typename std::underlying_type<T>::type underlying;
+        if (!decodeTo(underlying)) {
+            return false;
+        }
+        value = (T)underlying;
+        return true;
+    }
+
+    //Extra elements of sequences with fixed size are decoded to temporary element to move to the next value
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::sequence>) {
+        unsigned long long count;
+        if (!readVarint(count) || count > end - position) {
+            return false;
+        }
+        unsigned long decoded = CodableSequence<T>::resize(value, count);
+        for (unsigned long i = 0; i < count; i++) {
+            if (i < decoded) {
+                decodeTo(value[i]);
+            } else {
+                typename T::value_type extra;
+                decodeTo(extra);
+            }
+        }
+        return true;
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::map>) {
+        unsigned long long count;
+        //Every entry takes at least one byte, so bigger count means malformed data
+        if (!readVarint(count) || count > end - position) {
+            return false;
+        }
+        value.clear();
+        std::string key;
+        for (unsigned long i = 0; i < count; i++) {
+            if (!decodeTo(key)) {
+                return false;
+            }
+            decodeTo(value[key]);
+        }
+        return true;
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodableKindConstant<CodableKind::optional>) {
+        bool present;
+        if (!decodeTo(present)) {
+            return false;
+        }
+        if (!present) {
+            CodableOptional<T>::reset(value);
+            return true;
+        }
+        return decodeTo(CodableOptional<T>::emplace(value));
+    }
+    //Reading length of closure and getting container for its fields
+    bool readClosure(BinaryDecodeContainer& closure);
+
+    template <class T>
+    void readFields(T& value, std::true_type) {
+        CodableFieldDecoder<BinaryDecodeContainer> visitor = { this };
+        codableVisit(value, visitor);
+    }
+
+    template <class T>
+    void readFields(T& value, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->decode(this);
+        }
+    }
+};
+
+//Binary encoder class
+//Like JSON encoder, it has no state: reuse one container to encode many documents without allocations.
+class BinaryEncoder: Encoder {
+public:
+    BinaryEncodeContainer container();
+    BinaryEncodeContainer container(CoderSink* sink);
+};
+
+//Binary decoder class
+//Containers created by decoder are valid until reset() is called or decoder is destroyed.
+//Consists of:
+// buffers - data of decoded documents, containers refer to them (buffers after usedBuffers are free for reuse)
+// usedBuffers - count of buffers that keep data of documents decoded since the last reset
+class BinaryDecoder: Decoder {
+private:
+    std::deque<std::string> buffers;
+    unsigned long usedBuffers;
+
+    std::string& nextBuffer();
+    BinaryDecodeContainer lastBuffer();
+public:
+    BinaryDecoder();
+
+    //Content is copied to buffer of decoder, so buffer is reused after reset
+    BinaryDecodeContainer container(const std::string& content);
+    BinaryDecodeContainer container(const char* content, unsigned long length);
+    //Content is moved to decoder without copying
+    BinaryDecodeContainer container(std::string&& content);
+
+    //Releasing all documents, buffers are kept for the next documents
+    void reset();
+
+    BinaryDecoder(const BinaryDecoder&) = delete;
+    BinaryDecoder& operator=(const BinaryDecoder&) = delete;
+};
+
+#endif
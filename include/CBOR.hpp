@@ -0,0 +1,506 @@
+#ifndef CBOR_H
+#define CBOR_H
+
+#include "Codable.hpp"
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//Concise Binary Object Representation (RFC 8949)
+//Closures are written as indefinite-length maps with text keys, vectors and other sequences as definite-length arrays,
+//std::map and std::unordered_map as definite-length maps, empty optional values as null,
+//integers in the shortest form and floating point numbers in the shortest form that keeps exact value
+//(preferred serialization). Decoder accepts any well-formed CBOR with definite or indefinite lengths.
+
+//Container for encoding to CBOR
+//Like JSON containers, every container appends data directly to the output of the whole document.
+//Consists of:
+// content - encoded data (filled by containers created by encoder, unless sink is provided)
+// output - pointer to data of the document (NULL for containers created by encoder, they use content)
+// sink - destination where output is flushed to by pieces (NULL if data is kept in content)
+class CBOREncodeContainer: public CoderContainer {
+public:
+    std::string content;
+
+    //Encoding std::vector as array
+    template <typename T>
+    void encode(const std::vector<T>& value, CodingKey key) {
+        writeKey(key);
+        writeArray(value);
+    }
+
+    //Encoding methods for standard data types
+
+    void encode(bool value, CodingKey key = CodingKey());
+    void encode(int value, CodingKey key = CodingKey());
+    void encode(long long value, CodingKey key = CodingKey());
+    void encode(unsigned long long value, CodingKey key = CodingKey());
+    void encode(float value, CodingKey key = CodingKey());
+    void encode(double value, CodingKey key = CodingKey());
+    void encode(const std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, unsigned long length, CodingKey key, bool withQuotes = true);
+
+    //Encoding method for classes with Codable protocol or list of fields and for other types by their kinds
+    //(integers, enums, sequences, maps and optional values, see CodableTraits.hpp)
+    template <class T>
+    void encode(const T& value, CodingKey key) {
+        encodeValue(value, key, CodableKindTag<T>());
+    }
+
+    //Encoding method for value of any type without key
+    template <class T>
+    void encode(const T& value) {
+        begin();
+        encodeValue(value, CodingKey(), CodableKindTag<T>());
+        end();
+    }
+
+    //Encoding std::vector as array without key
+    template <typename T>
+    void encode(const std::vector<T>& value) {
+        begin();
+        writeArray(value);
+        end();
+    }
+
+    //Clearing encoded data of the highest container, its capacity is kept for the next document
+    void reset();
+
+    CBOREncodeContainer();
+    CBOREncodeContainer(CoderSink* sink);
+
+private:
+    std::string* output;
+    CoderSink* sink;
+
+    //Constructor for nested closures, they write to output of parent
+    CBOREncodeContainer(CBOREncodeContainer* parent);
+
+    //Getting data of the document
+    std::string& data() {
+        return output != NULL ? *output : content;
+    }
+
+    void begin();
+    void end();
+    //Flushing output to sink when it becomes big enough
+    void flush(bool force = false);
+    //Writing initial byte with major type and argument in the shortest form
+    void writeHead(unsigned char major, unsigned long long argument);
+    //Writing key of the next field (nothing for values without key)
+    void writeKey(const CodingKey& key);
+    void writeFloating(double value);
+    void writeNull();
+
+    //Encoding of values by kinds of their types (key is written here)
+
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::object>) {
+        static_assert(CodableHasFields<T>::value || std::is_polymorphic<T>::value, "Type has neither list of fields nor Codable protocol");
+        writeKey(key);
+        writeClosure(value);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::integer>) {
+        encode((typename CodableInteger<T>::Wide)value, key);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::enumeration>) {
+        typedef typename std::underlying_type<T>::type Underlying;
+        encode((typename CodableInteger<Underlying>::Wide)value, key);
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::sequence>) {
+        writeKey(key);
+        writeArray(value);
+    }
+
+    //Count of entries is known, so map has definite length unlike closures
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::map>) {
+        writeKey(key);
+        CBOREncodeContainer closure(this);
+        writeHead(5, value.size());
+        for (const auto& entry : value) {
+            closure.encode(entry.second, CodingKey(entry.first));
+            flush();
+        }
+        flush();
+    }
+
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::optional>) {
+        if (CodableOptional<T>::hasValue(value)) {
+            encode(CodableOptional<T>::value(value), key);
+        } else {
+            writeKey(key);
+            writeNull();
+        }
+    }
+
+    template <class T>
+    void writeClosure(const T& value) {
+        CBOREncodeContainer closure(this);
+        //Indefinite-length map, count of fields is not known before encoding
+        data() += (char)0xBF;
+        //Encode methods and visitors take non-const objects, but they don't modify them
+        writeFields(const_cast<T&>(value), &closure, std::integral_constant<bool, CodableHasFields<T>::value>());
+        data() += (char)0xFF;
+        flush();
+    }
+
+    //Encoding fields of class with list of fields (static dispatch)
+    template <class T>
+    void writeFields(T& value, CBOREncodeContainer* closure, std::true_type) {
+        CodableFieldEncoder<CBOREncodeContainer> visitor = { closure };
+        codableVisit(value, visitor);
+    }
+
+    //Encoding fields of class with Codable protocol (virtual call)
+    template <class T>
+    void writeFields(T& value, CBOREncodeContainer* closure, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->encode(closure);
+        }
+    }
+
+    //Writing std::vector or other sequence as array
+    template <typename S>
+    void writeArray(const S& value) {
+        CBOREncodeContainer array(this);
+        writeHead(4, value.size());
+        for (const auto& element : value) {
+            array.encode(element, CodingKey());
+            flush();
+        }
+        flush();
+    }
+};
+
+//Container for decoding from CBOR
+//Container refers to one data item in source buffer which is kept alive by decoder, nothing is parsed in advance:
+//fields of maps are found by scanning from the last found entry, so fields that are decoded in encoding order
+//are found at once.
+//Consists of:
+// source - pointer to source buffer
+// length - length of source buffer
+// offset - position of data item
+// major - major type of data item (8 if data item is malformed)
+// itemsOffset - position of the first element or entry (for arrays and maps)
+// itemsCount - count of elements or entries (-1 for indefinite length)
+// end - position after data item (0 until data item is decoded)
+// cursor - position of the last found map entry
+// cursorIndex - index of that entry
+// cursorEnd - position after value of that entry (0 until value is decoded)
+//Decoded values report their ends to containers, so nested data items are read once and not skipped again.
+class CBORDecodeContainer: public CoderContainer {
+public:
+    const char* source;
+    unsigned long length;
+    unsigned long offset;
+    unsigned char major;
+    unsigned long itemsOffset;
+    unsigned long long itemsCount;
+    unsigned long end;
+    unsigned long cursor;
+    unsigned long long cursorIndex;
+    unsigned long cursorEnd;
+
+    //Getting container of value of map entry with specific key, returns false if there is no such key
+    bool find(CodingKey key, CBORDecodeContainer& value);
+    //Checking if data item is null
+    bool isNull() const;
+
+    //Decoding methods that fill existing value, they return false and keep value if key is not found or value has other type
+
+    bool decodeTo(bool& value, CodingKey key = CodingKey());
+    bool decodeTo(int& value, CodingKey key = CodingKey());
+    bool decodeTo(long long& value, CodingKey key = CodingKey());
+    bool decodeTo(unsigned long long& value, CodingKey key = CodingKey());
+    bool decodeTo(float& value, CodingKey key = CodingKey());
+    bool decodeTo(double& value, CodingKey key = CodingKey());
+    bool decodeTo(std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+
+    template <typename T>
+    bool decodeTo(std::vector<T>& value, CodingKey key = CodingKey()) {
+        CBORDecodeContainer found;
+        CBORDecodeContainer* array = target(key, found);
+        if (array == NULL || array->major != 4) {
+            return false;
+        }
+        bool isIndefinite = array->itemsCount == indefinite;
+        //Every element takes at least one byte, so bigger count means malformed data
+        if (!isIndefinite && array->itemsCount > length - array->itemsOffset) {
+            return false;
+        }
+        value.clear();
+        if (!isIndefinite) {
+            value.resize(array->itemsCount);
+        }
+        unsigned long position = array->itemsOffset;
+        for (unsigned long i = 0; isIndefinite ? !isBreak(position) : i < array->itemsCount; i++) {
+            if (isIndefinite) {
+                if (position >= length) {
+                    return false;
+                }
+                value.resize(i + 1);
+            }
+            CBORDecodeContainer element(source, length, position);
+            element.decodeTo(value[i]);
+            if (element.end != 0) {
+                position = element.end;
+            } else if (!skip(position)) {
+                return false;
+            }
+        }
+        finish(array, isIndefinite ? position + 1 : position);
+        return true;
+    }
+
+    //Elements of std::vector<bool> are bits that can't be decoded in place, so they are decoded through deque
+    bool decodeTo(std::vector<bool>& value, CodingKey key = CodingKey()) {
+        std::deque<bool> elements;
+        if (!decodeTo(elements, key)) {
+            return false;
+        }
+        value.assign(elements.begin(), elements.end());
+        return true;
+    }
+
+    //Decoding of classes with Codable protocol or list of fields and of other types by their kinds (see CodableTraits.hpp)
+    //Integers out of range of their types aren't decoded, null clears optional values
+    template <class T>
+    bool decodeTo(T& value, CodingKey key = CodingKey()) {
+        return decodeValue(value, key, CodableKindTag<T>());
+    }
+
+    //Decoding methods that return value, provided sample is returned if key is not found
+
+    bool decode(bool type, CodingKey key);
+    int decode(int type, CodingKey key);
+    long long decode(long long type, CodingKey key);
+    float decode(float type, CodingKey key);
+    double decode(double type, CodingKey key);
+    std::string decode(std::string type, CodingKey key, bool withQuotes = true);
+
+    template <class T>
+    T decode(T type, CodingKey key) {
+        decodeTo(type, key);
+        return type;
+    }
+
+    template<typename T>
+    T decode(T type) {
+        decodeTo(type);
+        return type;
+    }
+
+    CBORDecodeContainer();
+    CBORDecodeContainer(const char* source, unsigned long length, unsigned long offset);
+
+private:
+    static const unsigned long long indefinite = ~0ULL;
+
+    //Getting container of value with specific key (this container for empty key, NULL if key is not found)
+    CBORDecodeContainer* target(CodingKey key, CBORDecodeContainer& found);
+    //Saving end of decoded data item, so it isn't skipped again
+    void finish(CBORDecodeContainer* item, unsigned long end);
+    //Finding end of map after decoding its fields (0 if map is malformed)
+    unsigned long mapEnd() const;
+    //Reading key of map entry, position is moved to its value
+    bool readKey(unsigned long& position, const CodingKey& key, bool& matches) const;
+    //Reading head of data item, position is moved to its content
+    bool readHead(unsigned long& position, unsigned char& major, unsigned char& info, unsigned long long& argument) const;
+    //Moving position to the next data item
+    bool skip(unsigned long& position, int depth = 0) const;
+    //Checking if there is break byte at position (the end of indefinite-length item)
+    bool isBreak(unsigned long position) const {
+        return position < length && (unsigned char)source[position] == 0xFF;
+    }
+    //Reading number of any type (integer or floating point)
+    bool readNumber(double& floating, long long& integer, bool& isInteger, unsigned long& end) const;
+
+    //Decoding of values by kinds of their types
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::object>) {
+        CBORDecodeContainer found;
+        CBORDecodeContainer* closure = target(key, found);
+        if (closure == NULL || closure->major != 5) {
+            return false;
+        }
+        closure->readFields(value, std::integral_constant<bool, CodableHasFields<T>::value>());
+        finish(closure, closure->mapEnd());
+        return true;
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::integer>) {
+        typename CodableInteger<T>::Wide wide;
+        return decodeTo(wide, key) && CodableInteger<T>::narrow(wide, value);
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::enumeration>) {
+        typename std::underlying_type<T>::type underlying;
+        if (!decodeTo(underlying, key)) {
+            return false;
+        }
+        value = (T)underlying;
+        return true;
+    }
+
+    //Count of elements of indefinite-length array is found before decoding, so sequence is resized once
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::sequence>) {
+        CBORDecodeContainer found;
+        CBORDecodeContainer* array = target(key, found);
+        if (array == NULL || array->major != 4) {
+            return false;
+        }
+        unsigned long long count = array->itemsCount;
+        unsigned long position = array->itemsOffset;
+        if (count == indefinite) {
+            for (count = 0; !isBreak(position); count++) {
+                if (position >= length || !skip(position)) {
+                    return false;
+                }
+            }
+            position = array->itemsOffset;
+        } else if (count > length - position) {
+            return false;
+        }
+        unsigned long decoded = CodableSequence<T>::resize(value, count);
+        for (unsigned long i = 0; i < count; i++) {
+            CBORDecodeContainer element(source, length, position);
+            if (i < decoded) {
+                element.decodeTo(value[i]);
+            }
+            if (element.end != 0) {
+                position = element.end;
+            } else if (!skip(position)) {
+                return false;
+            }
+        }
+        finish(array, array->itemsCount == indefinite ? position + 1 : position);
+        return true;
+    }
+
+    //Map is filled with all entries that have text keys, it is cleared by value of other type (like vector)
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::map>) {
+        CBORDecodeContainer found;
+        CBORDecodeContainer* map = target(key, found);
+        if (map == NULL) {
+            return false;
+        }
+        value.clear();
+        if (map->major != 5) {
+            return true;
+        }
+        bool isIndefinite = map->itemsCount == indefinite;
+        unsigned long position = map->itemsOffset;
+        std::string name;
+        for (unsigned long long i = 0; isIndefinite ? !isBreak(position) : i < map->itemsCount; i++) {
+            if (position >= length) {
+                return false;
+            }
+            CBORDecodeContainer entryKey(source, length, position);
+            bool hasName = entryKey.decodeTo(name);
+            if (entryKey.end != 0) {
+                position = entryKey.end;
+            } else if (!skip(position)) {
+                return false;
+            }
+            CBORDecodeContainer entry(source, length, position);
+            if (hasName) {
+                entry.decodeTo(value[name]);
+            }
+            if (entry.end != 0) {
+                position = entry.end;
+            } else if (!skip(position)) {
+                return false;
+            }
+        }
+        finish(map, isIndefinite ? position + 1 : position);
+        return true;
+    }
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::optional>) {
+        CBORDecodeContainer found;
+        CBORDecodeContainer* item = target(key, found);
+        if (item == NULL) {
+            return false;
+        }
+        if (item->isNull()) {
+            CodableOptional<T>::reset(value);
+            finish(item, item->offset + 1);
+            return true;
+        }
+        bool decoded = item->decodeTo(CodableOptional<T>::emplace(value));
+        //End of value is saved by container of value, parent map needs it too
+        if (item != this && item->end != 0) {
+            finish(item, item->end);
+        }
+        return decoded;
+    }
+
+    template <class T>
+    void readFields(T& value, std::true_type) {
+        CodableFieldDecoder<CBORDecodeContainer> visitor = { this };
+        codableVisit(value, visitor);
+    }
+
+    template <class T>
+    void readFields(T& value, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->decode(this);
+        }
+    }
+};
+
+//CBOR encoder class
+//Like JSON encoder, it has no state: reuse one container to encode many documents without allocations.
+class CBOREncoder: Encoder {
+public:
+    CBOREncodeContainer container();
+    CBOREncodeContainer container(CoderSink* sink);
+};
+
+//CBOR decoder class
+//Containers created by decoder are valid until reset() is called or decoder is destroyed.
+//Consists of:
+// buffers - data of decoded documents, containers refer to them (buffers after usedBuffers are free for reuse)
+// usedBuffers - count of buffers that keep data of documents decoded since the last reset
+class CBORDecoder: Decoder {
+private:
+    std::deque<std::string> buffers;
+    unsigned long usedBuffers;
+
+    std::string& nextBuffer();
+    CBORDecodeContainer lastBuffer();
+public:
+    CBORDecoder();
+
+    //Content is copied to buffer of decoder, so buffer is reused after reset
+    CBORDecodeContainer container(const std::string& content);
+    CBORDecodeContainer container(const char* content, unsigned long length);
+    //Content is moved to decoder without copying
+    CBORDecodeContainer container(std::string&& content);
+
+    //Releasing all documents, buffers are kept for the next documents
+    void reset();
+
+    CBORDecoder(const CBORDecoder&) = delete;
+    CBORDecoder& operator=(const CBORDecoder&) = delete;
+};
+
+#endif
@@ -1,12 +1,48 @@
 #ifndef CODABLE_H
 #define CODABLE_H
 
+#include "CodableFields.hpp"
+#include "CodableTraits.hpp"
+#include <cstring>
 #include <string>
-typedef std::string CodingKey;
+
+//Key of field
+//Key only refers to text, so it is passed by value without copying or allocations (like string_view)
+//Consists of:
+// data - pointer to the first character of key
+// length - count of characters
+class CodingKey {
+public:
+    const char* data;
+    unsigned long length;
+
+    CodingKey() : data(""), length(0) {}
+    CodingKey(const char* key) : data(key), length(strlen(key)) {}
+    CodingKey(const std::string& key) : data(key.data()), length(key.length()) {}
+    CodingKey(const char* data, unsigned long length) : data(data), length(length) {}
+
+    bool empty() const {
+        return length == 0;
+    }
+
+    std::string str() const {
+        return std::string(data, length);
+    }
+
+    bool operator ==(const CodingKey& key) const {
+        return length == key.length && memcmp(data, key.data, length) == 0;
+    }
+
+    bool operator !=(const CodingKey& key) const {
+        return !(*this == key);
+    }
+};
 
 //Types of encoders/decoders
 enum class CoderType {
-    json
+    json,
+    binary,
+    cbor
 };
 
 //Container for encoding/decoding
@@ -17,6 +53,15 @@ public:
     virtual ~CoderContainer() {}
 };
 
+//Destination for encoded data
+//Encoders write data in document order by big pieces, so whole document doesn't have to be kept in memory
+class CoderSink {
+public:
+    virtual void write(const char* data, unsigned long length) = 0;
+
+    virtual ~CoderSink() {}
+};
+
 class Encoder {
 public:
     CoderType type;
@@ -0,0 +1,140 @@
+#ifndef CODABLE_FIELDS_H
+#define CODABLE_FIELDS_H
+
+#include <type_traits>
+#include <utility>
+
+//Declarative list of fields for Codable classes
+//Macro is written inside of class body and lists fields that are encoded and decoded with keys equal to their names:
+//
+//    class Contact {
+//    public:
+//        std::string name;
+//        PhoneNumber phone_number;
+//        bool is_valid;
+//
+//        CODABLE_FIELDS(Contact, name, phone_number, is_valid)
+//    };
+//
+//Encoders and decoders call visitor for every field in the listed order, so the code for class is generated
+//at compile time and inlined, without virtual calls, RTTI and runtime type checks.
+//Class doesn't have to inherit Codable. Up to 64 fields are supported.
+
+#define CODABLE_FIELDS(Type, ...) \
+    template <class CodableVisitor> \
+    friend void codableVisit(Type& object, CodableVisitor& visitor) { \
+        CODABLE_EXPAND(CODABLE_FOR_EACH(CODABLE_VISIT_FIELD, __VA_ARGS__)) \
+    }
+
+#define CODABLE_VISIT_FIELD(field) visitor(#field, object.field);
+
+//Calling action for every argument (extra expansions are needed for MSVC preprocessor)
+#define CODABLE_EXPAND(x) x
+#define CODABLE_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, NAME, ...) NAME
+#define CODABLE_FOR_EACH(action, ...) CODABLE_EXPAND(CODABLE_SELECT(__VA_ARGS__, CODABLE_FOR_EACH_64, CODABLE_FOR_EACH_63, CODABLE_FOR_EACH_62, CODABLE_FOR_EACH_61, CODABLE_FOR_EACH_60, CODABLE_FOR_EACH_59, CODABLE_FOR_EACH_58, CODABLE_FOR_EACH_57, CODABLE_FOR_EACH_56, CODABLE_FOR_EACH_55, CODABLE_FOR_EACH_54, CODABLE_FOR_EACH_53, CODABLE_FOR_EACH_52, CODABLE_FOR_EACH_51, CODABLE_FOR_EACH_50, CODABLE_FOR_EACH_49, CODABLE_FOR_EACH_48, CODABLE_FOR_EACH_47, CODABLE_FOR_EACH_46, CODABLE_FOR_EACH_45, CODABLE_FOR_EACH_44, CODABLE_FOR_EACH_43, CODABLE_FOR_EACH_42, CODABLE_FOR_EACH_41, CODABLE_FOR_EACH_40, CODABLE_FOR_EACH_39, CODABLE_FOR_EACH_38, CODABLE_FOR_EACH_37, CODABLE_FOR_EACH_36, CODABLE_FOR_EACH_35, CODABLE_FOR_EACH_34, CODABLE_FOR_EACH_33, CODABLE_FOR_EACH_32, CODABLE_FOR_EACH_31, CODABLE_FOR_EACH_30, CODABLE_FOR_EACH_29, CODABLE_FOR_EACH_28, CODABLE_FOR_EACH_27, CODABLE_FOR_EACH_26, CODABLE_FOR_EACH_25, CODABLE_FOR_EACH_24, CODABLE_FOR_EACH_23, CODABLE_FOR_EACH_22, CODABLE_FOR_EACH_21, CODABLE_FOR_EACH_20, CODABLE_FOR_EACH_19, CODABLE_FOR_EACH_18, CODABLE_FOR_EACH_17, CODABLE_FOR_EACH_16, CODABLE_FOR_EACH_15, CODABLE_FOR_EACH_14, CODABLE_FOR_EACH_13, CODABLE_FOR_EACH_12, CODABLE_FOR_EACH_11, CODABLE_FOR_EACH_10, CODABLE_FOR_EACH_9, CODABLE_FOR_EACH_8, CODABLE_FOR_EACH_7, CODABLE_FOR_EACH_6, CODABLE_FOR_EACH_5, CODABLE_FOR_EACH_4, CODABLE_FOR_EACH_3, CODABLE_FOR_EACH_2, CODABLE_FOR_EACH_1)(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_1(action, x) action(x)
+#define CODABLE_FOR_EACH_2(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_1(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_3(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_2(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_4(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_3(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_5(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_4(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_6(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_5(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_7(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_6(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_8(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_7(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_9(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_8(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_10(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_9(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_11(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_10(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_12(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_11(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_13(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_12(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_14(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_13(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_15(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_14(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_16(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_15(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_17(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_16(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_18(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_17(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_19(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_18(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_20(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_19(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_21(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_20(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_22(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_21(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_23(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_22(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_24(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_23(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_25(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_24(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_26(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_25(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_27(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_26(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_28(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_27(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_29(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_28(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_30(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_29(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_31(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_30(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_32(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_31(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_33(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_32(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_34(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_33(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_35(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_34(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_36(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_35(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_37(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_36(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_38(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_37(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_39(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_38(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_40(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_39(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_41(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_40(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_42(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_41(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_43(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_42(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_44(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_43(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_45(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_44(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_46(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_45(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_47(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_46(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_48(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_47(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_49(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_48(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_50(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_49(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_51(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_50(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_52(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_51(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_53(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_52(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_54(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_53(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_55(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_54(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_56(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_55(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_57(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_56(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_58(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_57(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_59(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_58(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_60(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_59(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_61(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_60(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_62(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_61(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_63(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_62(action, __VA_ARGS__))
+#define CODABLE_FOR_EACH_64(action, x, ...) action(x) CODABLE_EXPAND(CODABLE_FOR_EACH_63(action, __VA_ARGS__))
+
+//Visitor that does nothing, it is used only for detection of field lists
+struct CodableFieldsProbe {
+    template <class T>
+    void operator()(const char* key, T& field) {}
+};
+
+//Checking if class has list of fields declared with CODABLE_FIELDS
+template <class T>
+class CodableHasFields {
+    template <class U>
+    static char test(decltype(codableVisit(std::declval<U&>(), std::declval<CodableFieldsProbe&>()))*);
+    template <class U>
+    static long test(...);
+public:
+    static const bool value = sizeof(test<T>(0)) == 1;
+};
+
+//Visitor that encodes every field to container with field's name as key
+template <class Container>
+struct CodableFieldEncoder {
+    Container* container;
+
+    template <class T>
+    void operator()(const char* key, T& field) {
+        container->encode(field, key);
+    }
+};
+
+//Visitor that decodes every field in place from value of container with field's name as key
+//Current value of field is kept if container doesn't have the key
+template <class Container>
+struct CodableFieldDecoder {
+    Container* container;
+
+    template <class T>
+    void operator()(const char* key, T& field) {
+        container->decodeTo(field, key);
+    }
+};
+
+#endif
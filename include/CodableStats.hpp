@@ -0,0 +1,160 @@
+#ifndef CODABLE_STATS_H
+#define CODABLE_STATS_H
+
+#include <atomic>
+#include <chrono>
+
+//Counter of statistics that can be increased by several threads
+//Order of increments doesn't matter, so relaxed operations are enough. Counter is read and copied as unsigned long long.
+//Consists of:
+// value - value of counter
+struct CodableCounter {
+    std::atomic<unsigned long long> value;
+
+    CodableCounter(unsigned long long value = 0) : value(value) {}
+
+    CodableCounter(const CodableCounter& counter) : value((unsigned long long)counter) {}
+
+    CodableCounter& operator=(const CodableCounter& counter) {
+        value.store((unsigned long long)counter, std::memory_order_relaxed);
+        return *this;
+    }
+
+    CodableCounter& operator+=(unsigned long long increment) {
+        value.fetch_add(increment, std::memory_order_relaxed);
+        return *this;
+    }
+
+    operator unsigned long long() const {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+//Statistics of encoder or decoder
+//Counters are collected only when library is built with CODABLE_ENABLE_STATS (CMake option of the same name),
+//otherwise instrumentation macros are empty, containers don't have pointers to statistics and all counters stay zero.
+//Times are in nanoseconds. Phases can overlap: expanding of lazy containers is part of field decoding too.
+//Counters are relaxed atomics, so documents can be decoded by several threads (JSONParallelDecoder) with exact counts.
+//Times of decoding are summed over threads then, so they can be longer than the whole decoding.
+//Consists of:
+// bytesScanned - count of characters scanned by structural scanner
+// nodesCreated - count of created containers
+// allocations - count of memory requests to arena (containers, lists of children and key indexes)
+// keyLookups - count of searches of children by key
+// keyProbes - count of children keys compared during searches
+// numbersParsed - count of parsed numbers
+// numbersWritten - count of written numbers
+// bytesWritten - count of characters of encoded documents
+// tokenizeTime - time of finding structural characters
+// treeBuildTime - time of building containers from structural characters
+// fieldDecodeTime - time of decoding values from containers (measured on the highest decodeTo() call)
+// contentTime - time of encoding documents (measured on the highest value)
+struct CodableStats {
+    CodableCounter bytesScanned;
+    CodableCounter nodesCreated;
+    CodableCounter allocations;
+    CodableCounter keyLookups;
+    CodableCounter keyProbes;
+    CodableCounter numbersParsed;
+    CodableCounter numbersWritten;
+    CodableCounter bytesWritten;
+    CodableCounter tokenizeTime;
+    CodableCounter treeBuildTime;
+    CodableCounter fieldDecodeTime;
+    CodableCounter contentTime;
+
+    void reset() {
+        *this = CodableStats();
+    }
+
+    //Adding counters of work that was done separately (like pieces of parallel encoding)
+    void add(const CodableStats& stats) {
+        bytesScanned += stats.bytesScanned;
+        nodesCreated += stats.nodesCreated;
+        allocations += stats.allocations;
+        keyLookups += stats.keyLookups;
+        keyProbes += stats.keyProbes;
+        numbersParsed += stats.numbersParsed;
+        numbersWritten += stats.numbersWritten;
+        bytesWritten += stats.bytesWritten;
+        tokenizeTime += stats.tokenizeTime;
+        treeBuildTime += stats.treeBuildTime;
+        fieldDecodeTime += stats.fieldDecodeTime;
+        contentTime += stats.contentTime;
+    }
+};
+
+#ifdef CODABLE_ENABLE_STATS
+
+//Timer that adds time of its scope to counter of statistics (nothing is measured if statistics are NULL)
+//Consists of:
+// stats - statistics where time is added
+// counter - counter of time
+// start - start time of scope
+class CodableStatsTimer {
+public:
+    CodableStatsTimer(CodableStats* stats, CodableCounter CodableStats::* counter) {
+        this->stats = stats;
+        this->counter = counter;
+        if (stats != NULL) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~CodableStatsTimer() {
+        if (stats != NULL) {
+            stats->*counter += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+private:
+    CodableStats* stats;
+    CodableCounter CodableStats::* counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+//Timer of the highest decodeTo() call, nested calls for the same statistics don't measure anything
+//Statistics that are measured now are kept per thread, so threads that decode the same document measure their own calls.
+//Consists of:
+// previous - statistics that were measured by the thread before this call
+// timer - timer of the highest call
+class CodableDecodeTimer {
+public:
+    CodableDecodeTimer(CodableStats* stats) : timer(stats != measured() ? stats : NULL, &CodableStats::fieldDecodeTime) {
+        previous = measured();
+        if (stats != NULL) {
+            measured() = stats;
+        }
+    }
+
+    ~CodableDecodeTimer() {
+        measured() = previous;
+    }
+
+private:
+    CodableStats* previous;
+    CodableStatsTimer timer;
+
+    //Statistics whose decodeTo() call is measured by current thread (NULL if there is no such call)
+    static CodableStats*& measured() {
+        static thread_local CodableStats* stats = NULL;
+        return stats;
+    }
+};
+
+//Adding value to counter of statistics
+#define CODABLE_STAT(stats, counter, value) do { if ((stats) != NULL) { (stats)->counter += (value); } } while (0)
+//Measuring time of the rest of scope
+#define CODABLE_STAT_TIME(stats, counter) CodableStatsTimer codableStatsTimer(stats, &CodableStats::counter)
+//Measuring time of the highest decodeTo() call
+#define CODABLE_STAT_DECODE_TIME(stats) CodableDecodeTimer codableDecodeTimer(stats)
+
+#else
+
+#define CODABLE_STAT(stats, counter, value) do {} while (0)
+#define CODABLE_STAT_TIME(stats, counter) do {} while (0)
+#define CODABLE_STAT_DECODE_TIME(stats) do {} while (0)
+
+#endif
+
+#endif
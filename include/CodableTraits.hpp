@@ -0,0 +1,199 @@
+#ifndef CODABLE_TRAITS_H
+#define CODABLE_TRAITS_H
+
+#include <array>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+//Compile-time dispatch of types that containers encode and decode with templates
+//Containers have methods for bool, int, long long, unsigned long long, float, double, std::string and std::vector,
+//every other type gets its kind here, and containers pick the code for this kind by tag at compile time,
+//so there are no runtime checks and no temporary vectors or strings.
+
+//Kinds of types:
+// object - class with Codable protocol or list of fields (closure)
+// integer - other integer types (char, short, unsigned, long and so on), values out of range aren't decoded
+// enumeration - enum or enum class, written as its underlying integer
+// sequence - std::array and std::deque (array like std::vector), std::array keeps its size
+// map - std::map and std::unordered_map with string keys (closure with entries as fields)
+// optional - nullable type with CodableOptional specialization (null when it is empty)
+enum class CodableKind {
+    object,
+    integer,
+    enumeration,
+    sequence,
+    map,
+    optional
+};
+
+//Access to value of nullable type
+//Specialize it for own nullable types with the same static functions, std::unique_ptr, std::shared_ptr
+//and std::optional (C++17) are supported. Consists of:
+// isOptional - true for nullable types
+// hasValue() - checking if value is present
+// value() - getting present value
+// emplace() - getting value for decoding (default value is created if it isn't present)
+// reset() - removing value
+template <class T>
+struct CodableOptional {
+    static const bool isOptional = false;
+};
+
+template <class T>
+struct CodableOptional<std::unique_ptr<T>> {
+    static const bool isOptional = true;
+
+    static bool hasValue(const std::unique_ptr<T>& optional) {
+        return optional != nullptr;
+    }
+
+    static const T& value(const std::unique_ptr<T>& optional) {
+        return *optional;
+    }
+
+    static T& emplace(std::unique_ptr<T>& optional) {
+        if (optional == nullptr) {
+            optional.reset(new T());
+        }
+        return *optional;
+    }
+
+    static void reset(std::unique_ptr<T>& optional) {
+        optional.reset();
+    }
+};
+
+template <class T>
+struct CodableOptional<std::shared_ptr<T>> {
+    static const bool isOptional = true;
+
+    static bool hasValue(const std::shared_ptr<T>& optional) {
+        return optional != nullptr;
+    }
+
+    static const T& value(const std::shared_ptr<T>& optional) {
+        return *optional;
+    }
+
+    //Shared value isn't changed, decoding creates new one
+    static T& emplace(std::shared_ptr<T>& optional) {
+        optional = std::make_shared<T>();
+        return *optional;
+    }
+
+    static void reset(std::shared_ptr<T>& optional) {
+        optional.reset();
+    }
+};
+
+#if __cplusplus >= 201703L
+template <class T>
+struct CodableOptional<std::optional<T>> {
+    static const bool isOptional = true;
+
+    static bool hasValue(const std::optional<T>& optional) {
+        return optional.has_value();
+    }
+
+    static const T& value(const std::optional<T>& optional) {
+        return *optional;
+    }
+
+    static T& emplace(std::optional<T>& optional) {
+        if (!optional.has_value()) {
+            optional.emplace();
+        }
+        return *optional;
+    }
+
+    static void reset(std::optional<T>& optional) {
+        optional.reset();
+    }
+};
+#endif
+
+//Resizing of sequences before decoding of count elements, returns count of elements that are decoded to sequence
+template <class T>
+struct CodableSequence {
+    static const bool isSequence = false;
+};
+
+template <class T, std::size_t N>
+struct CodableSequence<std::array<T, N>> {
+    static const bool isSequence = true;
+
+    //Size of array is fixed, extra elements are skipped and missing ones keep their values
+    static unsigned long resize(std::array<T, N>& sequence, unsigned long count) {
+        return count < N ? count : N;
+    }
+};
+
+template <class T>
+struct CodableSequence<std::deque<T>> {
+    static const bool isSequence = true;
+
+    static unsigned long resize(std::deque<T>& sequence, unsigned long count) {
+        sequence.clear();
+        sequence.resize(count);
+        return count;
+    }
+};
+
+template <class T>
+struct CodableMap {
+    static const bool isMap = false;
+};
+
+template <class T, class Compare, class Allocator>
+struct CodableMap<std::map<std::string, T, Compare, Allocator>> {
+    static const bool isMap = true;
+};
+
+template <class T, class Hash, class Equal, class Allocator>
+struct CodableMap<std::unordered_map<std::string, T, Hash, Equal, Allocator>> {
+    static const bool isMap = true;
+};
+
+//Finding kind of type
+template <class T>
+struct CodableKindOf {
+    static const CodableKind value =
+        std::is_enum<T>::value ? CodableKind::enumeration :
+        std::is_integral<T>::value ? CodableKind::integer :
+        CodableSequence<T>::isSequence ? CodableKind::sequence :
+        CodableMap<T>::isMap ? CodableKind::map :
+        CodableOptional<T>::isOptional ? CodableKind::optional :
+        CodableKind::object;
+};
+
+//Tags of kinds for overloads of containers
+template <CodableKind kind>
+using CodableKindConstant = std::integral_constant<CodableKind, kind>;
+
+template <class T>
+using CodableKindTag = CodableKindConstant<CodableKindOf<T>::value>;
+
+//Converting integer to the widest type of the same signedness and back with range check
+template <class T>
+struct CodableInteger {
+    typedef typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type Wide;
+
+    static bool narrow(Wide wide, T& value) {
+        if (wide < (Wide)std::numeric_limits<T>::min() || wide > (Wide)std::numeric_limits<T>::max()) {
+            return false;
+        }
+        value = (T)wide;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include "Codable.hpp"
+#include <string>
+#include <vector>
+
+//Read-only mapping of the whole file to memory
+//Text of file is used in place without copying, pages are read by system when they are accessed.
+//File must not be changed while it is mapped. On systems without mmap file is read to buffer.
+//Consists of:
+// data - text of file (valid until close() is called or file is destroyed)
+// length - size of file in bytes
+// mapping - address of mapping (NULL if file isn't mapped)
+// buffer - text of file on systems without mmap
+class CodableMappedFile {
+public:
+    const char* data;
+    unsigned long length;
+
+    CodableMappedFile();
+    ~CodableMappedFile();
+
+    //Mapping file for sequential reading, returns false if file can't be opened or mapped
+    bool open(const char* path);
+    //Unmapping file
+    void close();
+
+    CodableMappedFile(const CodableMappedFile&) = delete;
+    CodableMappedFile& operator=(const CodableMappedFile&) = delete;
+
+private:
+    void* mapping;
+    std::string buffer;
+};
+
+//Sink that writes encoded text to file descriptor through buffer of fixed size
+//Memory doesn't depend on size of output, pieces that are bigger than buffer are written without copying.
+//Descriptor isn't closed by sink.
+//Consists of:
+// descriptor - file descriptor where text is written
+// buffer - text that isn't written yet
+// capacity - size of buffer
+// failed - true if some write failed (the rest of text is dropped)
+class CodableFileSink: public CoderSink {
+public:
+    CodableFileSink(int descriptor, unsigned long capacity = 1 << 16);
+    //Writing the rest of buffer
+    ~CodableFileSink();
+
+    void write(const char* data, unsigned long length) override;
+    //Writing buffer to descriptor, returns false if some write failed
+    bool flush();
+
+    bool failed() const {
+        return writeFailed;
+    }
+
+    CodableFileSink(const CodableFileSink&) = delete;
+    CodableFileSink& operator=(const CodableFileSink&) = delete;
+
+private:
+    int descriptor;
+    std::vector<char> buffer;
+    unsigned long used;
+    bool writeFailed;
+
+    //Writing data to descriptor until all of it is written
+    void writeAll(const char* data, unsigned long length);
+};
+
+#endif
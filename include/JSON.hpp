@@ -1,23 +1,28 @@
 #ifndef JSON_H
 #define JSON_H
 
+#include "Arena.hpp"
 #include "Codable.hpp"
+#include "CodableStats.hpp"
+#include "JSONFormat.hpp"
+#include <deque>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 //Empty key for arrays and the highest closures
 #define MAIN_CONTAINER_KEY ""
 
 //Container for encoding to/decoding from JSON format
+class JSONContainer: public CoderContainer {};
+
+//Part of JSON text in source buffer of decoder
 //Consists of:
-// childrenIndexes - array of children's indexes in containers array (applicable only for arrays and closures)
-// key - name of container
-// content - text representation of children (for arrays and closures) or value (for variables)
-class JSONContainer: public CoderContainer {
-public:
-    std::vector<unsigned long> childrenIndexes;
-    std::string key;
-    std::string content;
+// offset - position of the first character
+// length - count of characters
+struct JSONSpan {
+    unsigned long offset;
+    unsigned long length;
 };
 
 //Types of JSON containers:
@@ -31,109 +36,379 @@ enum class JSONContainerType {
 };
 
 //Container for encoding to JSON format
+//Every container appends its text directly to the output of the whole document in document order,
+//so text of nested containers is never built separately and copied to the parent.
 //Consists of:
-// containers - pointer to array of all the containers used in encoding
+// content - encoded text (filled by containers created by encoder, unless sink is provided)
 // encodingType - container type (closure, array or variable)
-// value - data value (for variables only)
+// output - pointer to text of the document (NULL for containers created by encoder, they use content)
+// sink - destination where output is flushed to by pieces (NULL if text is kept in content)
+// isEmpty - true until the first child is written, used for separating children with commas
+// format - format of text (the same for all nested containers)
+// depth - level of nesting of children of container (0 for the highest container)
+// statistics - statistics of encoding of documents by the highest container (only with CODABLE_ENABLE_STATS)
+// parentStats - statistics of the highest container (for nested containers, only with CODABLE_ENABLE_STATS)
+// countedLength - length of content that is already counted in statistics (only with CODABLE_ENABLE_STATS)
 class JSONEncodeContainer: public JSONContainer {
+    //Parallel encoder writes text of arrays that is encoded by pieces directly to output
+    friend class JSONParallelEncoder;
+
 public:
-    std::vector<JSONEncodeContainer>* containers;
+    std::string content;
     JSONContainerType encodingType;
-    std::string value;
 
-    //method for converting container to JSON format
-    void generateContent();
+    //All values are taken by reference, so encoding never copies objects, only their text is written
 
     //Encoding std::vector as array
     template <typename T>
-    void encode(std::vector<T> value, CodingKey key) {
-        JSONEncodeContainer array(this->containers);
-        array.key = key;
-        array.encodingType = JSONContainerType::array;
+    void encode(const std::vector<T>& value, CodingKey key) {
+        writeKey(key);
+        writeArray(value);
+    }
+
+    //Encoding methods for standard data types 
+
+    void encode(bool value, CodingKey key = CodingKey());
+    void encode(int value, CodingKey key = CodingKey());
+    void encode(long long value, CodingKey key = CodingKey());
+    void encode(unsigned long long value, CodingKey key = CodingKey());
+    void encode(float value, CodingKey key = CodingKey());
+    void encode(double value, CodingKey key = CodingKey());
+    void encode(const std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, CodingKey key = CodingKey(), bool withQuotes = true);
+    void encode(const char* value, unsigned long length, CodingKey key, bool withQuotes = true);
+
+    //Encoding method for classes with Codable protocol or list of fields and for other types by their kinds
+    //(integers, enums, sequences, maps and optional values, see CodableTraits.hpp)
+    template <class T>
+    void encode(const T& value, CodingKey key) {
+        encodeValue(value, key, CodableKindTag<T>());
+    }
+
+    //Encoding method for value of any type without key
+    template <class T>
+    void encode(const T& value) {
+        CODABLE_STAT_TIME(currentStats(), contentTime);
+        begin();
+        encodeValue(value, CodingKey(), CodableKindTag<T>());
+        end();
+    }
+
+    //Encoding std::vector as array without key
+    template <typename T>
+    void encode(const std::vector<T>& value) {
+        CODABLE_STAT_TIME(currentStats(), contentTime);
+        begin();
+        writeArray(value);
+        end();
+    }
 
-        for (int i = 0; i < value.size(); i++) {
-            JSONEncodeContainer valueContainer(containers);
-            valueContainer.encode(value[i]);
-            containers->push_back(valueContainer);
-            array.childrenIndexes.push_back(containers->size() - 1);
+    //Encoding value without key as the next line of newline-delimited JSON (JSON Lines)
+    //Text of previous lines is kept, so many records are written to one buffer (or sink) without copying
+    //Records must be written on one line, so containers with pretty format write them in standard style
+    //Values of any type are written like values of documents (usually records are closures)
+    template <class T>
+    void encodeLine(const T& value) {
+        CODABLE_STAT_TIME(currentStats(), contentTime);
+        JSONFormatStyle style = format.style;
+        if (style == JSONFormatStyle::pretty) {
+            format.style = JSONFormatStyle::standard;
         }
+        //Every line is separate value, so it doesn't get comma
+        isEmpty = true;
+        encode(value, CodingKey());
+        format.style = style;
+        text() += '\n';
+        flush();
+        countWritten();
+    }
 
-        array.generateContent();
-        containers->push_back(array);
-        childrenIndexes.push_back(containers->size() - 1);
+    //Writing the rest of lines to sink (if it is provided)
+    void flushLines();
+
+    //Clearing encoded text of the highest container, its capacity is kept for the next document
+    //Encoding of the next value without key does the same, so one container can encode many documents
+    void reset();
+
+    //Statistics of documents encoded by this container (zeros unless library is built with CODABLE_ENABLE_STATS)
+    //Nested containers are created for every closure, so they don't have statistics when they aren't collected
+    const CodableStats& stats() const {
+#ifdef CODABLE_ENABLE_STATS
+        return statistics;
+#else
+        static const CodableStats empty;
+        return empty;
+#endif
     }
 
-    //Encoding methods for standard data types 
+    void resetStats() {
+#ifdef CODABLE_ENABLE_STATS
+        statistics.reset();
+#endif
+    }
 
-    void encode(bool value, CodingKey key="");
-    void encode(int value, CodingKey key="");
-    void encode(long long value, CodingKey key = "");
-    void encode(float value, CodingKey key="");
-    void encode(double value, CodingKey key = "");
-    void encode(std::string value, CodingKey key="", bool withQuotes = true);
+    JSONEncodeContainer();
+    JSONEncodeContainer(CoderSink* sink);
+    JSONEncodeContainer(CoderSink* sink, const JSONFormat& format);
+
+private:
+    std::string* output;
+    CoderSink* sink;
+    bool isEmpty;
+    JSONFormat format;
+    unsigned depth;
+#ifdef CODABLE_ENABLE_STATS
+    CodableStats statistics;
+    CodableStats* parentStats;
+    unsigned long countedLength;
+
+    //Statistics where counters of this container are added
+    CodableStats* currentStats() {
+        return output != NULL ? parentStats : &statistics;
+    }
+#endif
+
+    //Constructor for nested closures and arrays, they write to output of parent
+    JSONEncodeContainer(JSONEncodeContainer* parent, JSONContainerType encodingType);
+
+    //Getting text of the document
+    std::string& text() {
+        return output != NULL ? *output : content;
+    }
+
+    //Starting the highest value of the document
+    void begin();
+    //Finishing the highest value of the document (flushing everything to sink)
+    void end();
+    //Adding length of text that isn't counted yet to statistics (for the highest container without sink)
+    void countWritten();
+    //Flushing output to sink when it becomes big enough
+    void flush(bool force = false);
+    //Writing separator and key of the next child
+    void writeKey(const CodingKey& key);
+    //Writing line before closing bracket of closure or array with children in pretty format
+    void writeClosingLine(const JSONEncodeContainer& child);
+    //Writing integer without key
+    void writeInteger(long long value);
+    void writeInteger(unsigned long long value);
+
+    //Encoding of values by kinds of their types (key is written here)
 
-    //Encoding method for classes with Codable protocol 
     template <class T>
-    void encode(T value, CodingKey key) {
-        JSONEncodeContainer result(this->containers);
-        result.key = key;
-        result.encodingType = JSONContainerType::closure;
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::object>) {
+        static_assert(CodableHasFields<T>::value || std::is_polymorphic<T>::value, "Type has neither list of fields nor Codable protocol");
+        writeKey(key);
+        writeClosure(value);
+    }
 
-        if (std::is_polymorphic<T>::value) {
-            Codable* casted = dynamic_cast<Codable*>(&value);
-            casted->encode(&result);
-        }
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::integer>) {
+        writeKey(key);
+        writeInteger((typename CodableInteger<T>::Wide)value);
+    }
 
-        result.generateContent();
-        containers->push_back(result);
-        childrenIndexes.push_back(containers->size() - 1);
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::enumeration>) {
+        typedef typename std::underlying_type<T>::type Underlying;
+        writeKey(key);
+        writeInteger((typename CodableInteger<Underlying>::Wide)value);
     }
 
-    //Encoding method for classes with Codable protocol without key
     template <class T>
-    void encode(T value) {
-        encodingType = JSONContainerType::closure;
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::sequence>) {
+        writeKey(key);
+        writeArray(value);
+    }
 
-        if (std::is_polymorphic<T>::value) {
-            Codable* casted = dynamic_cast<Codable*>(&value);
-            casted->encode(this);
+    //Entries of map are written as fields of closure, keys are escaped like keys of fields
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::map>) {
+        writeKey(key);
+        JSONEncodeContainer closure(this, JSONContainerType::closure);
+        text() += '{';
+        for (const auto& entry : value) {
+            closure.encode(entry.second, CodingKey(entry.first));
+            flush();
         }
+        writeClosingLine(closure);
+        text() += '}';
+        flush();
+    }
 
-        generateContent();
+    template <class T>
+    void encodeValue(const T& value, CodingKey key, CodableKindConstant<CodableKind::optional>) {
+        if (CodableOptional<T>::hasValue(value)) {
+            encode(CodableOptional<T>::value(value), key);
+        } else {
+            writeKey(key);
+            text() += "null";
+        }
     }
 
-    //Encoding std::vector as array without key
-    template <typename T>
-    void encode(std::vector<T> value) {
-        encodingType = JSONContainerType::array;
+    template <class T>
+    void writeClosure(const T& value) {
+        JSONEncodeContainer closure(this, JSONContainerType::closure);
+        text() += '{';
+        //Encode methods and visitors take non-const objects, but they don't modify them
+        writeFields(const_cast<T&>(value), &closure, std::integral_constant<bool, CodableHasFields<T>::value>());
+        writeClosingLine(closure);
+        text() += '}';
+        flush();
+    }
 
-        for (int i = 0; i < value.size(); i++) {
-            JSONEncodeContainer valueContainer(containers);
-            valueContainer.encode(value[i]);
-            containers->push_back(valueContainer);
-            childrenIndexes.push_back(containers->size() - 1);
-        }
+    //Encoding fields of class with list of fields (static dispatch)
+    template <class T>
+    void writeFields(T& value, JSONEncodeContainer* closure, std::true_type) {
+        CodableFieldEncoder<JSONEncodeContainer> visitor = { closure };
+        codableVisit(value, visitor);
+    }
 
-        generateContent();
+    //Encoding fields of class with Codable protocol (virtual call)
+    template <class T>
+    void writeFields(T& value, JSONEncodeContainer* closure, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->encode(closure);
+        }
     }
 
-    JSONEncodeContainer(std::vector<JSONEncodeContainer>* containers);
-    JSONEncodeContainer(std::string key, std::string content, std::vector<JSONEncodeContainer>* containers);
+    //Writing std::vector or other sequence as array
+    template <typename S>
+    void writeArray(const S& value) {
+        JSONEncodeContainer array(this, JSONContainerType::array);
+        text() += '[';
+        for (const auto& element : value) {
+            array.encode(element, MAIN_CONTAINER_KEY);
+            //Big arrays are written to sink by pieces, not after the closing bracket
+            flush();
+        }
+        writeClosingLine(array);
+        text() += ']';
+        flush();
+    }
 };
 
+template <class T>
+class JSONElements;
+class JSONParser;
+
 //Container for decoding from JSON format
+//Container doesn't own any text, it refers to source buffer which is kept alive by decoder.
+//Containers, their children lists and key indexes are allocated in arena of decoder, so they never move.
 //Consists of:
-// containers - pointer to array of all the containers used in decoding
+// arena - arena of decoder, where all the data of container is allocated
 // parsedType - container type (closure, array or variable)
+// keyEscaped - true if name of container has escapes (it is compared with keys after unescaping)
+// source - pointer to source buffer
+// keySpan - name of container (without quotes)
+// contentSpan - text of value (for variables) or the whole text with brackets (for arrays and closures)
+// children - array of pointers to children (applicable only for arrays and closures, call expand() before reading it in lazy mode)
+// childrenCount - count of children
+// lookupCursor - position of child that follows the last found one (fields are usually decoded in encoding order)
+// keyIndex - hash table of children positions (plus one) by keys, built on demand for closures with many children
+// keyIndexSize - size of hash table (0 until it is built)
+// expander - parser that builds children of closure or array on the first access in lazy mode (NULL if they are built)
+// stats - statistics of decoder (only with CODABLE_ENABLE_STATS, see CodableStats)
 class JSONDecodeContainer: public JSONContainer {
 public:
-    std::vector<JSONDecodeContainer>* containers;
+    Arena* arena;
     JSONContainerType parsedType;
+    bool keyEscaped;
+    const char* source;
+    JSONSpan keySpan;
+    JSONSpan contentSpan;
+    JSONDecodeContainer** children;
+    unsigned long childrenCount;
+    unsigned long lookupCursor;
+    unsigned* keyIndex;
+    unsigned long keyIndexSize;
+    JSONParser* expander;
+#ifdef CODABLE_ENABLE_STATS
+    CodableStats* stats;
+#endif
+
+    //Building children of closure or array that isn't expanded yet in lazy mode (see JSONDecoder::setLazy)
+    //Only one level is built, children closures and arrays are expanded on access to them
+    void expand() {
+        if (expander != NULL) {
+            expandChildren();
+        }
+    }
+
+    //Copying name and text of container
+    std::string keyString() const;
+    std::string contentString() const;
+    //Decoding unescaped name of container to string (its capacity is kept)
+    void keyTo(std::string& key) const;
+    //Checking if value of container is null
+    bool isNull() const;
+    //Comparing name of container with key (without copying unless name has escapes)
+    bool hasKey(CodingKey key) const;
     
     //Getting container with specific key from children containers
-    JSONDecodeContainer* operator [](std::string key);
-    
-    //Decoding methods for standard data types 
+    JSONDecodeContainer* operator [](CodingKey key);
+
+    //Getting container of value with specific key (this container for empty key)
+    JSONDecodeContainer* target(CodingKey key) {
+        return key.empty() ? this : operator[](key);
+    }
+
+    //Decoding methods that fill existing value, they return false and keep value if key is not found or value can't be parsed
+    //Strings and vectors keep their capacity, so decoding to the same objects many times doesn't allocate memory
+
+    bool decodeTo(bool& value, CodingKey key = CodingKey());
+    bool decodeTo(int& value, CodingKey key = CodingKey());
+    bool decodeTo(long long& value, CodingKey key = CodingKey());
+    bool decodeTo(unsigned long long& value, CodingKey key = CodingKey());
+    bool decodeTo(float& value, CodingKey key = CodingKey());
+    bool decodeTo(double& value, CodingKey key = CodingKey());
+    bool decodeTo(std::string& value, CodingKey key = CodingKey(), bool withQuotes = true);
+
+    //Decoding of array to vector, its size is set to count of elements at once
+    template <typename T>
+    bool decodeTo(std::vector<T>& value, CodingKey key = CodingKey()) {
+        CODABLE_STAT_DECODE_TIME(stats);
+        JSONDecodeContainer* array = target(key);
+        if (array == NULL) {
+            return false;
+        }
+        array->expand();
+        value.clear();
+        value.resize(array->childrenCount);
+        for (unsigned long i = 0; i < array->childrenCount; i++) {
+            array->children[i]->decodeTo(value[i]);
+        }
+        return true;
+    }
+
+    //Elements of std::vector<bool> are bits that can't be decoded in place, so they are decoded through deque
+    bool decodeTo(std::vector<bool>& value, CodingKey key = CodingKey()) {
+        std::deque<bool> elements;
+        if (!decodeTo(elements, key)) {
+            return false;
+        }
+        value.assign(elements.begin(), elements.end());
+        return true;
+    }
+
+    //Decoding of classes with Codable protocol or list of fields and of other types by their kinds (see CodableTraits.hpp)
+    //Integers out of range of their types aren't decoded, null clears optional values
+    template <class T>
+    bool decodeTo(T& value, CodingKey key = CodingKey()) {
+        CODABLE_STAT_DECODE_TIME(stats);
+        return decodeValue(value, key, CodableKindTag<T>());
+    }
+
+    //Range of elements of array that are decoded one by one, so neither vector nor containers of all elements are created
+    //Array that isn't expanded by parser (see JSONDecoder::setMaxDepth) is parsed by elements with constant memory
+    //Range is defined in JSONStream.hpp
+    template <class T>
+    JSONElements<T> elements(CodingKey key = CodingKey()) {
+        return JSONElements<T>(target(key));
+    }
+
+    //Decoding methods that return value, provided sample is returned if key is not found or value can't be parsed
+    //Sample is taken by value, so pass temporary object or use std::move to avoid copying
 
     bool decode(bool type, CodingKey key);
     int decode(int type, CodingKey key);
@@ -142,87 +417,207 @@ public:
     double decode(double type, CodingKey key);
     std::string decode(std::string type, CodingKey key, bool withQuotes = true);
     
-    //Decoding method for classes with Codable protocol
+    //Decoding method for classes with Codable protocol or list of fields and for vectors
     template <class T>
     T decode(T type, CodingKey key) {
-        if (std::is_polymorphic<T>::value) {
-            Codable* casted = dynamic_cast<Codable*>(&type);
-            JSONDecodeContainer* jsonContainer = operator[](key);
-
-            //If key is empty, then decode to current container
-            if (key == MAIN_CONTAINER_KEY) {
-                jsonContainer = this;
-            }
-
-            if (jsonContainer != NULL) {
-                CoderContainer* container = static_cast<CoderContainer*>(jsonContainer);
-                if (container != NULL) {
-                    casted->decode(container);
-                }
-            }
-        }
+        decodeTo(type, key);
+        //Returning modified type sample (it is moved)
+        return type;
+    }
 
-        //Returning modified type sample
+    //Decoding method for all fields without key (value in this container)
+    template<typename T>
+    T decode(T type) {
+        decodeTo(type);
         return type;
     }
 
-    //Decoding method for array
-    template <typename T>
-    std::vector<T> decode(std::vector<T> type, CodingKey key) {
-        std::vector<T> result;
-        auto array = operator[](key);
+    JSONDecodeContainer(Arena* arena);
 
-        if (array != NULL) {
-            for (int i = 0; i < array->childrenIndexes.size(); i++) {
-                T item = containers->data()[array->childrenIndexes[i]].decode(T());
-                result.push_back(item);
-            }
+private:
+    void expandChildren();
+
+    //Decoding of values by kinds of their types
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::object>) {
+        JSONDecodeContainer* closure = target(key);
+        if (closure == NULL) {
+            return false;
         }
+        closure->readFields(value, std::integral_constant<bool, CodableHasFields<T>::value>());
+        return true;
+    }
 
-        return result;
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::integer>) {
+        typename CodableInteger<T>::Wide wide;
+        return decodeTo(wide, key) && CodableInteger<T>::narrow(wide, value);
     }
 
-    //Decoding method for array without key (array in this container)
-    template <typename T>
-    std::vector<T> decode(std::vector<T> type) {
-        std::vector<T> result;
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::enumeration>) {
+        typename std::underlying_type<T>::type underlying;
+        if (!decodeTo(underlying, key)) {
+            return false;
+        }
+        value = (T)underlying;
+        return true;
+    }
 
-        for (int i = 0; i < childrenIndexes.size(); i++) {
-            T item = containers->data()[childrenIndexes[i]].decode(T());
-            result.push_back(item);
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::sequence>) {
+        JSONDecodeContainer* array = target(key);
+        if (array == NULL) {
+            return false;
+        }
+        array->expand();
+        unsigned long count = CodableSequence<T>::resize(value, array->childrenCount);
+        for (unsigned long i = 0; i < count; i++) {
+            array->children[i]->decodeTo(value[i]);
         }
+        return true;
+    }
 
-        return result;
+    //Map is filled with all fields of closure, it is cleared by value of other type (like vector)
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::map>) {
+        JSONDecodeContainer* closure = target(key);
+        if (closure == NULL) {
+            return false;
+        }
+        closure->expand();
+        value.clear();
+        if (closure->parsedType != JSONContainerType::closure) {
+            return true;
+        }
+        std::string name;
+        for (unsigned long i = 0; i < closure->childrenCount; i++) {
+            closure->children[i]->keyTo(name);
+            closure->children[i]->decodeTo(value[name]);
+        }
+        return true;
     }
-    
-    //Decoding method for all fields without key
-    template<typename T>
-    T decode(T type) {
-        return decode(type, MAIN_CONTAINER_KEY);
+
+    template <class T>
+    bool decodeValue(T& value, CodingKey key, CodableKindConstant<CodableKind::optional>) {
+        JSONDecodeContainer* child = target(key);
+        if (child == NULL) {
+            return false;
+        }
+        if (child->isNull()) {
+            CodableOptional<T>::reset(value);
+            return true;
+        }
+        return child->decodeTo(CodableOptional<T>::emplace(value));
+    }
+
+    //Decoding fields of class with list of fields (static dispatch)
+    template <class T>
+    void readFields(T& value, std::true_type) {
+        CodableFieldDecoder<JSONDecodeContainer> visitor = { this };
+        codableVisit(value, visitor);
     }
 
-    JSONDecodeContainer(std::string content, std::vector<JSONDecodeContainer>* containers);
-    JSONDecodeContainer(std::string key, std::string content, std::vector<JSONDecodeContainer>* containers);
+    //Decoding fields of class with Codable protocol (virtual call)
+    template <class T>
+    void readFields(T& value, std::false_type) {
+        if (std::is_polymorphic<T>::value) {
+            Codable* casted = dynamic_cast<Codable*>(&value);
+            casted->decode(this);
+        }
+    }
 };
 
 //JSON encoder class
+//Encoder keeps only format of text, all the text is kept by containers it creates.
+//Whitespaces of format are written together with the text in the same pass, so no format costs extra passes.
+//To encode many documents without allocations create container once and reuse it:
+//text in its content stays valid until the next value without key is encoded to it (or reset() is called).
 //Consists of:
-// containers - array of all containers created with use of this encoder
+// format - format of text of created containers (standard by default)
 class JSONEncoder: Encoder {
-private:
-    std::vector<JSONEncodeContainer> containers;
 public:
+    JSONEncoder(const JSONFormat& format = JSONFormat());
+
+    //Container that keeps encoded text in its content
     JSONEncodeContainer container();
+    //Container that writes encoded text to sink
+    JSONEncodeContainer container(CoderSink* sink);
+
+    //Setting format of text of containers created after this call
+    void setFormat(const JSONFormat& format);
+
+private:
+    JSONFormat format;
 };
 
+class CodableMappedFile;
+
 //JSON decoder class
+//Containers created by decoder (and all containers got from them) are valid until reset() is called or decoder is destroyed.
+//To decode many documents without allocations reuse one decoder and call reset() after each document:
+//memory of arena, source buffers and temporary arrays of parser are kept for the next documents.
 //Consists of:
-// containers - array of all containers created with use of this decoder
+// arena - arena where all containers created with use of this decoder are allocated (own or provided one)
+// parser - parser that keeps its temporary arrays between documents
+// buffers - source texts of decoded documents, containers refer to them (buffers after usedBuffers are free for reuse)
+// usedBuffers - count of buffers that keep texts of documents decoded since the last reset
+// files - mapped files of documents decoded since the last reset
+// statistics - statistics of parsing and decoding (see CodableStats)
 class JSONDecoder: Decoder {
 private:
-    std::vector<JSONDecodeContainer> containers;
+    Arena ownArena;
+    Arena* arena;
+    JSONParser* parser;
+    std::deque<std::string> buffers;
+    unsigned long usedBuffers;
+    std::vector<CodableMappedFile*> files;
+    CodableStats statistics;
+
+    //Getting the next free source buffer
+    std::string& nextBuffer();
+    //Parsing text in the last used buffer
+    JSONDecodeContainer parseBuffer();
 public:
-    JSONDecodeContainer container(std::string content);
+    JSONDecoder();
+    //Decoder that allocates containers in provided arena, arena must outlive decoder
+    JSONDecoder(Arena* arena);
+    ~JSONDecoder();
+
+    //Content is copied to buffer of decoder, so buffer is reused after reset
+    JSONDecodeContainer container(const std::string& content);
+    JSONDecodeContainer container(const char* content, unsigned long length);
+    //Content is moved to decoder without copying (old free buffer of decoder is left in content)
+    JSONDecodeContainer container(std::string&& content);
+    //File is mapped to memory and parsed in place without copying, it stays mapped until reset (and must not be changed)
+    //File that can't be opened gives empty container (nothing is decoded from it)
+    JSONDecodeContainer containerFromFile(const std::string& path);
+
+    //Setting count of levels of closures and arrays that are parsed to containers (0 - all of them, it is default)
+    //Deeper closures and arrays are kept as texts without children, arrays among them can be read with elements()
+    void setMaxDepth(unsigned long depth);
+    //Enabling lazy mode: only the highest closure or array is expanded, the others keep only their texts until
+    //their children are accessed, so decoding of few fields of big document costs scan of text and parsing of
+    //accessed containers only. Lazy containers must be decoded by one thread (JSONParallelDecoder handles them).
+    void setLazy(bool lazy);
+
+    //Statistics of documents decoded by this decoder (zeros unless library is built with CODABLE_ENABLE_STATS)
+    //Statistics are kept after reset()
+    const CodableStats& stats() const {
+        return statistics;
+    }
+
+    void resetStats() {
+        statistics.reset();
+    }
+
+    //Releasing all containers and texts in O(1), memory is kept for the next documents
+    //Containers created before reset must not be used after it
+    void reset();
+
+    JSONDecoder(const JSONDecoder&) = delete;
+    JSONDecoder& operator=(const JSONDecoder&) = delete;
 };
 
 #endif
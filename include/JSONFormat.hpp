@@ -0,0 +1,39 @@
+#ifndef JSON_FORMAT_H
+#define JSON_FORMAT_H
+
+#include <string>
+
+//Styles of JSON text:
+// standard - space after colon of key and no other whitespaces: {"key": [1,2]}
+// compact - no whitespaces at all, the smallest text: {"key":[1,2]}
+// pretty - every child of closure or array on its own line with indent, empty ones stay on one line
+enum class JSONFormatStyle {
+    standard,
+    compact,
+    pretty
+};
+
+//Format of JSON text written by encoder or reformatting
+//Consists of:
+// style - style of text
+// indent - count of spaces per level of nesting (only for pretty style)
+struct JSONFormat {
+    JSONFormatStyle style;
+    unsigned indent;
+
+    JSONFormat(JSONFormatStyle style = JSONFormatStyle::standard, unsigned indent = 4) {
+        this->style = style;
+        this->indent = indent;
+    }
+};
+
+//Writing JSON text again in specific format without building containers, the result is the same as text of encoder
+//with this format. Text is passed once: whitespaces between tokens are dropped, strings and other values are copied
+//as they are and whitespaces of format are inserted.
+//Appends text to output, returns false if brackets of text are unbalanced or string isn't finished
+bool jsonReformat(const char* text, unsigned long length, const JSONFormat& format, std::string& output);
+
+//Removing all whitespaces between tokens (reformatting to compact style)
+bool jsonMinify(const char* text, unsigned long length, std::string& output);
+
+#endif
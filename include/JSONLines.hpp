@@ -0,0 +1,73 @@
+#ifndef JSON_LINES_H
+#define JSON_LINES_H
+
+#include "JSON.hpp"
+#include "JSONParser.hpp"
+#include "ThreadPool.hpp"
+#include <functional>
+#include <vector>
+
+//Newline-delimited JSON (JSON Lines): every record is one JSON value on its own line
+//Records are encoded with JSONEncodeContainer::encodeLine(). Raw newlines can't appear inside of JSON strings,
+//so boundaries of records are found with one memchr pass over the text, and records are parsed separately
+//with arena and parser that are reused for every record.
+
+//Decoder of newline-delimited JSON
+//Records can be decoded by several threads: lines are split into chunks that are decoded by thread pool,
+//every chunk is decoded to its part of result vector, so order of records is kept.
+//Consists of:
+// pool - pool of decoding threads
+// lines - texts of records of the last text (empty lines are skipped)
+// workers - parsers of workers of pool (the first one is used by calling thread)
+class JSONLinesDecoder {
+public:
+    //Decoder that uses specific count of threads (1 - only calling thread)
+    JSONLinesDecoder(unsigned threads = 1);
+    ~JSONLinesDecoder();
+
+    //Decoding all records of text to vector, returns count of records
+    template <class T>
+    unsigned long decode(const char* text, unsigned long length, std::vector<T>& records) {
+        findLines(text, length);
+        records.clear();
+        records.resize(lines.size());
+        run([&](JSONRecordParser& worker, unsigned long begin, unsigned long end) {
+            for (unsigned long i = begin; i < end; i++) {
+                worker.parse(text + lines[i].offset, lines[i].length)->decodeTo(records[i]);
+            }
+        });
+        return lines.size();
+    }
+
+    //Decoding records one by one in calling thread and passing them to callback, returns count of records
+    //Neither lines nor records are kept, so memory doesn't depend on count of records
+    template <class T>
+    unsigned long decodeEach(const char* text, unsigned long length, std::function<void(T&)> callback) {
+        unsigned long count = 0;
+        JSONSpan line;
+        for (unsigned long position = 0; nextLine(text, length, position, line); ) {
+            T record = T();
+            workers[0]->parse(text + line.offset, line.length)->decodeTo(record);
+            callback(record);
+            count++;
+        }
+        return count;
+    }
+
+    JSONLinesDecoder(const JSONLinesDecoder&) = delete;
+    JSONLinesDecoder& operator=(const JSONLinesDecoder&) = delete;
+
+private:
+    CodableThreadPool pool;
+    std::vector<JSONSpan> lines;
+    std::vector<JSONRecordParser*> workers;
+
+    //Finding the next non-empty line from position, position is moved after it
+    static bool nextLine(const char* text, unsigned long length, unsigned long& position, JSONSpan& line);
+    //Finding all non-empty lines of text
+    void findLines(const char* text, unsigned long length);
+    //Running function for ranges of lines on all workers
+    void run(const std::function<void(JSONRecordParser&, unsigned long, unsigned long)>& function);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+//Locale-independent conversion of numbers to and from JSON text
+//Floating point numbers are written in a form that is parsed back to exactly the same value (Grisu2). It is usually
+//the shortest one, but for a few values Grisu2 writes more digits than needed.
+//Parsing uses exact fast path for short numbers and Eisel-Lemire algorithm for the rest, long numbers that are too
+//close to the middle between two floating point numbers are rounded by exact comparison with big integers.
+
+//Size of buffer that is enough for any number written by functions below
+const int JSONNumberBufferSize = 32;
+
+//Writing number to buffer, returns count of written characters
+//Non-finite floating point numbers are written as null, because JSON doesn't have them
+int jsonWriteInteger(long long value, char* buffer);
+int jsonWriteUnsigned(unsigned long long value, char* buffer);
+int jsonWriteDouble(double value, char* buffer);
+int jsonWriteFloat(float value, char* buffer);
+
+//Parsing number from text, returns false if text is not a number (or doesn't fit in integer type)
+//Integers are also parsed from numbers with fraction or exponent, fraction is truncated
+bool jsonParseInteger(const char* text, unsigned long length, long long& value);
+bool jsonParseUnsigned(const char* text, unsigned long length, unsigned long long& value);
+bool jsonParseDouble(const char* text, unsigned long length, double& value);
+bool jsonParseFloat(const char* text, unsigned long length, float& value);
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef JSON_PARALLEL_H
+#define JSON_PARALLEL_H
+
+#include "JSON.hpp"
+#include "JSONParser.hpp"
+#include "JSONStream.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//Parallel decoding of big arrays
+//Elements of array are split into chunks that are decoded to T by thread pool, every chunk is decoded to its part
+//of result vector, so result is the same as with JSONDecodeContainer::decodeTo().
+//Elements of parsed array are decoded from their containers. Array that isn't expanded by parser
+//(see JSONDecoder::setMaxDepth and JSONDecoder::setLazy) is scanned once for boundaries of elements, then elements
+//are parsed and decoded by threads, so parsing of them is parallel too.
+//T must be safe to decode in several threads (Codable classes must not change shared state in decode()).
+//Consists of:
+// pool - pool of decoding threads (not owned)
+// workers - parsers of workers of pool (the first one is used by calling thread)
+// spans - texts of elements of array that isn't expanded
+class JSONParallelDecoder {
+public:
+    JSONParallelDecoder(CodableThreadPool* pool);
+    ~JSONParallelDecoder();
+
+    //Decoding array with specific key (or container itself for empty key) to vector
+    //Returns false and keeps value if key is not found
+    template <typename T>
+    bool decodeTo(JSONDecodeContainer& container, std::vector<T>& value, CodingKey key = CodingKey()) {
+        JSONDecodeContainer* array = container.target(key);
+        if (array == NULL) {
+            return false;
+        }
+        value.clear();
+        shareStats(array);
+        if (array->childrenCount > 0) {
+            value.resize(array->childrenCount);
+            pool->parallelFor(value.size(), grain(value.size()), [&](unsigned worker, unsigned long begin, unsigned long end) {
+                for (unsigned long i = begin; i < end; i++) {
+                    JSONDecodeContainer* element = array->children[i];
+                    //Lazy elements are parsed by parser of worker, so shared parser and arena aren't changed
+                    if (element->expander != NULL) {
+                        element = workers[worker]->parse(element->source + element->contentSpan.offset, element->contentSpan.length);
+                    }
+                    element->decodeTo(value[i]);
+                }
+            });
+            return true;
+        }
+        if (array->parsedType != JSONContainerType::array) {
+            return true;
+        }
+        const char* text = findElements(array);
+        value.resize(spans.size());
+        pool->parallelFor(value.size(), grain(value.size()), [&](unsigned worker, unsigned long begin, unsigned long end) {
+            JSONRecordParser* parser = workers[worker];
+            for (unsigned long i = begin; i < end; i++) {
+                parser->parse(text + spans[i].offset, spans[i].length)->decodeTo(value[i]);
+            }
+        });
+        return true;
+    }
+
+    JSONParallelDecoder(const JSONParallelDecoder&) = delete;
+    JSONParallelDecoder& operator=(const JSONParallelDecoder&) = delete;
+
+private:
+    CodableThreadPool* pool;
+    std::vector<JSONRecordParser*> workers;
+    std::vector<JSONSpan> spans;
+
+    //Size of chunk of elements for specific count of them
+    unsigned long grain(unsigned long count) const;
+    //Finding texts of elements of array that isn't expanded, returns text of array
+    const char* findElements(JSONDecodeContainer* array);
+    //Parsers of workers add counters to statistics of decoder of array (only with CODABLE_ENABLE_STATS)
+    void shareStats(JSONDecodeContainer* array);
+};
+
+//Parallel encoding of big arrays
+//Elements of array are split into chunks that are encoded by thread pool to separate pieces of text, every piece
+//starts with comma if it isn't the first one, so joined pieces are the same text as with JSONEncodeContainer::encode().
+//Offsets of pieces in output are found by prefix sum of their lengths, output is resized once and pieces are copied
+//to it by threads. For containers with sink pieces are written to sink one after another without copying.
+//T must be safe to encode in several threads (Codable classes must not change shared state in encode()).
+//Consists of:
+// pool - pool of encoding threads (not owned)
+// pieces - texts of chunks of the last array, their capacity is reused
+// offsets - offsets of pieces in text of array
+// statistics - statistics of pieces, they are added to statistics of container (only with CODABLE_ENABLE_STATS)
+class JSONParallelEncoder {
+public:
+    JSONParallelEncoder(CodableThreadPool* pool);
+
+    //Encoding array with key to container
+    template <typename T>
+    void encode(JSONEncodeContainer& container, const std::vector<T>& value, CodingKey key) {
+        encodePieces(container, value);
+        container.writeKey(key);
+        writePieces(container);
+    }
+
+    //Encoding array as the whole document of container
+    template <typename T>
+    void encode(JSONEncodeContainer& container, const std::vector<T>& value) {
+        CODABLE_STAT_TIME(container.currentStats(), contentTime);
+        encodePieces(container, value);
+        container.begin();
+        writePieces(container);
+        container.end();
+    }
+
+    JSONParallelEncoder(const JSONParallelEncoder&) = delete;
+    JSONParallelEncoder& operator=(const JSONParallelEncoder&) = delete;
+
+private:
+    CodableThreadPool* pool;
+    std::vector<std::string> pieces;
+    std::vector<unsigned long> offsets;
+#ifdef CODABLE_ENABLE_STATS
+    std::vector<CodableStats> statistics;
+#endif
+
+    //Encoding pieces of array that is written to container (with format and nesting of its children)
+    template <typename T>
+    void encodePieces(JSONEncodeContainer& container, const std::vector<T>& value) {
+        unsigned long count = value.size();
+        unsigned long grain = this->grain(count);
+        unsigned long chunks = (count + grain - 1) / grain;
+        if (pieces.size() < chunks) {
+            pieces.resize(chunks);
+        }
+        offsets.resize(chunks + 1);
+#ifdef CODABLE_ENABLE_STATS
+        statistics.resize(chunks);
+#endif
+        pool->parallelFor(chunks, 1, [&](unsigned worker, unsigned long begin, unsigned long end) {
+            for (unsigned long chunk = begin; chunk < end; chunk++) {
+                //Piece is encoded as continuation of array, so every element except the first one gets comma
+                JSONEncodeContainer array;
+                array.encodingType = JSONContainerType::array;
+                array.isEmpty = chunk == 0;
+                array.format = container.format;
+                array.depth = container.depth + 1;
+                array.content.swap(pieces[chunk]);
+                array.content.clear();
+                for (unsigned long i = chunk * grain; i < std::min(count, (chunk + 1) * grain); i++) {
+                    array.encode(value[i], MAIN_CONTAINER_KEY);
+                }
+                array.content.swap(pieces[chunk]);
+#ifdef CODABLE_ENABLE_STATS
+                statistics[chunk] = array.statistics;
+#endif
+            }
+        });
+#ifdef CODABLE_ENABLE_STATS
+        //Pieces are encoded by separate containers, their counters are added to statistics of container
+        CodableStats* stats = container.currentStats();
+        for (unsigned long chunk = 0; chunk < chunks && stats != NULL; chunk++) {
+            stats->add(statistics[chunk]);
+        }
+#endif
+        offsets[0] = 0;
+        for (unsigned long chunk = 0; chunk < chunks; chunk++) {
+            offsets[chunk + 1] = offsets[chunk] + pieces[chunk].length();
+        }
+    }
+
+    //Size of chunk of elements for specific count of them
+    unsigned long grain(unsigned long count) const;
+    //Writing array of encoded pieces to container (key is already written)
+    void writePieces(JSONEncodeContainer& container);
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include "Arena.hpp"
+#include "JSON.hpp"
+#include "JSONStructural.hpp"
+#include <string>
+#include <vector>
+
+//Single-pass JSON parser
+//Scans the text once and builds the tree of decoding containers directly from structural characters,
+//so nested closures and arrays are never re-scanned or split into temporary strings.
+//Text is processed by windows: positions of structural characters of the window are found with SIMD scanner
+//to the tape, then the tree is built from the tape, so memory for tape doesn't depend on size of text.
+//Closures and arrays deeper than maxDepth are not expanded: they get text spans without children.
+//Only brackets are counted inside of them, so they are skipped with one pass over structural characters.
+//In lazy mode only one level is expanded by every parse, the other containers are expanded by the same parser later.
+//Consists of:
+// arena - arena where parsed containers and their children lists are allocated
+// scanner - scanner of structural characters
+// tape - positions of structural characters of current window
+// frames - stack of closures and arrays that are opened at current position
+// children - already parsed children of all opened frames (each frame owns its tail)
+// maxDepth - count of levels of closures and arrays that are expanded (0 if there is no limit)
+// lazy - true if containers that aren't expanded are expanded on access
+// stats - statistics of decoder that uses parser (NULL if they aren't collected)
+class JSONParser {
+public:
+    JSONParser(Arena* arena);
+
+    //Setting count of levels of closures and arrays that are expanded (1 - only the highest one, 0 - all of them)
+    void setMaxDepth(unsigned long depth) {
+        maxDepth = depth;
+    }
+
+    //Setting lazy mode
+    void setLazy(bool lazy) {
+        this->lazy = lazy;
+    }
+
+    //Setting statistics where counters are added (see CodableStats), parsed containers get them too
+    void setStats(CodableStats* stats) {
+        this->stats = stats;
+    }
+
+    //Parses content and returns the highest container
+    //Parsed containers refer to content, so it must outlive them
+    JSONDecodeContainer* parse(const char* content, unsigned long length);
+    //Building children of container that isn't expanded (one level of them)
+    void expand(JSONDecodeContainer* container);
+
+private:
+    //Opened closure or array
+    //Consists of:
+    // container - parsed closure or array
+    // firstChild - position of container's first child in children array
+    // position - position of open bracket in source
+    struct Frame {
+        JSONDecodeContainer* container;
+        unsigned long firstChild;
+        unsigned long position;
+    };
+
+    Arena* arena;
+    JSONStructuralScanner scanner;
+    std::vector<unsigned> tape;
+    std::vector<Frame> frames;
+    std::vector<JSONDecodeContainer*> children;
+    unsigned long maxDepth;
+    bool lazy;
+    CodableStats* stats;
+    //Container that isn't expanded and depth of brackets inside of it (0 if there is no such container)
+    Frame skipped;
+    unsigned long skippedDepth;
+
+    const char* source;
+    //Position of previous structural character
+    long last;
+    //Key for the next value of current closure
+    JSONSpan pendingKey;
+    //The highest container (NULL until it is found)
+    JSONDecodeContainer* root;
+
+    //Parsing text between begin and end of source, positions of containers are relative to source
+    JSONDecodeContainer* parseRange(const char* source, unsigned long begin, unsigned long end);
+    //Scanning window of source to tape, returns count of structural characters
+    unsigned long scanWindow(unsigned long start, unsigned long length);
+    //Processing of structural character ({, }, [, ], : or ,) found outside of strings
+    void structural(unsigned long position);
+    //Creating container for value between two structural characters
+    void addVariable(unsigned long begin, unsigned long end);
+    void openContainer(JSONContainerType type, unsigned long position);
+    void closeContainer(unsigned long position);
+    //Closing container that isn't expanded
+    void closeSkipped(unsigned long position);
+    //Adding parsed container to current frame (or making it the highest one)
+    void attach(JSONDecodeContainer* container);
+    //Creating empty container with pending key
+    JSONDecodeContainer* createContainer(JSONContainerType type);
+};
+
+//Parser of many small documents (records, elements of arrays) to the same memory
+//Used by one thread, so threads that parse records in parallel have separate ones.
+//Consists of:
+// arena - storage of containers of current record, it is reset before every record
+// parser - parser of records
+class JSONRecordParser {
+public:
+    Arena arena;
+    JSONParser parser;
+
+    JSONRecordParser() : parser(&arena) {}
+
+    //Parsing record, container is valid until the next record is parsed
+    JSONDecodeContainer* parse(const char* text, unsigned long length) {
+        arena.reset();
+        return parser.parse(text, length);
+    }
+};
+
+#endif
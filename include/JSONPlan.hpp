@@ -0,0 +1,250 @@
+#ifndef JSON_PLAN_H
+#define JSON_PLAN_H
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONParser.hpp"
+#include "JSONStructural.hpp"
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class JSONPlanDecoder;
+
+//Decode plan of class with list of fields
+//Plan is built once for every class from its CODABLE_FIELDS: every field gets its key, hash of key, offset in object
+//and reader function for its type, so decoding of fields is a table lookup instead of comparing keys of tree nodes.
+//Consists of:
+// fields - fields in declaration order
+// index - hash table of fields positions (plus one) by keys
+class JSONDecodePlan {
+public:
+    //Field of class
+    //Consists of:
+    // key - name of field
+    // length - length of name
+    // hash - hash of name
+    // offset - offset of field in object
+    // read - function that decodes value of field's type from decoder to field
+    struct Field {
+        const char* key;
+        unsigned long length;
+        unsigned hash;
+        unsigned long offset;
+        void (*read)(JSONPlanDecoder& decoder, void* field);
+    };
+
+    std::vector<Field> fields;
+    std::vector<unsigned> index;
+
+    //Adding field, index is built by finish()
+    void add(const char* key, unsigned long offset, void (*read)(JSONPlanDecoder&, void*));
+    void finish();
+
+    //Finding field by key, cursor is position of the field that is expected next (fields usually go in declaration order)
+    const Field* find(const char* key, unsigned long length, unsigned long& cursor) const;
+};
+
+//Decoder of known classes directly from text
+//Text is scanned by structural scanner and values are decoded to fields of object right away with decode plans,
+//so containers of closures and arrays are never created. Keys in other order are found in hash table of plan,
+//unknown keys are skipped by counting brackets. Integers and enums of all types are parsed directly. Classes with
+//Codable protocol (without list of fields), sequences other than std::vector, maps and optional values are decoded
+//from their text by generic decoder.
+//Missing keys and values that can't be parsed keep current values of fields, like with JSONDecodeContainer::decodeTo().
+//Consists of:
+// text - text of current document
+// length - length of text
+// scanner - scanner of structural characters
+// tape - positions of structural characters of current window
+// scanned - count of scanned characters of text
+// windowStart - position of current window in text
+// tapeIndex - index of the next structural character in tape
+// tapeCount - count of structural characters in tape
+// last - position of the last read structural character (-1 at the beginning)
+// terminator - structural character after the last read value (0 at the end of text)
+// failed - true if text is malformed
+// fallback - parser of values that are decoded by generic decoder
+// key - unescaped key of the last field whose key has escapes
+class JSONPlanDecoder {
+public:
+    JSONPlanDecoder();
+
+    //Decoding document to value, returns false if text is malformed (value can be decoded partially)
+    template <class T>
+    bool decode(const char* text, unsigned long length, T& value) {
+        begin(text, length);
+        readValue(value);
+        //Nothing but whitespaces may follow the value
+        return !failed && terminator == 0;
+    }
+
+    template <class T>
+    bool decode(const std::string& text, T& value) {
+        return decode(text.data(), text.length(), value);
+    }
+
+    //Readers of values of every supported type, they read value and structural character after it
+
+    void readValue(bool& value);
+    void readValue(int& value);
+    void readValue(long long& value);
+    void readValue(unsigned long long& value);
+    void readValue(float& value);
+    void readValue(double& value);
+    void readValue(std::string& value);
+
+    template <typename T>
+    void readValue(std::vector<T>& value) {
+        //Vector is cleared by value of other type (null for example), like in generic decoder
+        value.clear();
+        if (!beginNested('[')) {
+            return;
+        }
+        if (!closes(']')) {
+            do {
+                value.emplace_back();
+                readValue(value.back());
+            } while (terminator == ',');
+            //Elements are followed by the closing bracket unless text is broken
+            failed = failed || terminator != ']';
+        }
+        readTerminator();
+    }
+
+    //Elements of std::vector<bool> are bits that can't be decoded in place, so they are decoded through deque
+    void readValue(std::vector<bool>& value) {
+        std::deque<bool> elements;
+        readObject(elements, std::false_type());
+        value.assign(elements.begin(), elements.end());
+    }
+
+    template <class T>
+    void readValue(T& value) {
+        readKind(value, CodableKindTag<T>());
+    }
+
+    //Plan of class, it is built on the first call
+    template <class T>
+    static const JSONDecodePlan& plan() {
+        static const JSONDecodePlan plan = buildPlan<T>();
+        return plan;
+    }
+
+    JSONPlanDecoder(const JSONPlanDecoder&) = delete;
+    JSONPlanDecoder& operator=(const JSONPlanDecoder&) = delete;
+
+private:
+    const char* text;
+    unsigned long length;
+    JSONStructuralScanner scanner;
+    std::vector<unsigned> tape;
+    unsigned long scanned;
+    unsigned long windowStart;
+    unsigned long tapeIndex;
+    unsigned long tapeCount;
+    long last;
+    char terminator;
+    bool failed;
+    JSONRecordParser fallback;
+    std::string key;
+
+    //Visitor that adds fields of object to plan
+    template <class T>
+    struct PlanBuilder {
+        JSONDecodePlan* plan;
+        T* object;
+
+        template <class F>
+        void operator()(const char* key, F& field) {
+            plan->add(key, (const char*)&field - (const char*)object, &JSONPlanDecoder::readField<F>);
+        }
+    };
+
+    template <class T>
+    static JSONDecodePlan buildPlan() {
+        JSONDecodePlan plan;
+        T object;
+        PlanBuilder<T> builder = { &plan, &object };
+        codableVisit(object, builder);
+        plan.finish();
+        return plan;
+    }
+
+    template <class F>
+    static void readField(JSONPlanDecoder& decoder, void* field) {
+        decoder.readValue(*static_cast<F*>(field));
+    }
+
+    //Decoding of values by kinds of their types
+
+    template <class T>
+    void readKind(T& value, CodableKindConstant<CodableKind::object>) {
+        readObject(value, std::integral_constant<bool, CodableHasFields<T>::value>());
+    }
+
+    template <class T>
+    void readKind(T& value, CodableKindConstant<CodableKind::integer>) {
+        typename CodableInteger<T>::Wide wide = 0;
+        JSONSpan span;
+        if (beginScalar(span) && parseInteger(span, wide)) {
+            CodableInteger<T>::narrow(wide, value);
+        }
+    }
+
+    template <class T>
+    void readKind(T& value, CodableKindConstant<CodableKind::enumeration>) {
+        typename std::underlying_type<T>::type underlying = (typename std::underlying_type<T>::type)value;
+        readValue(underlying);
+        value = (T)underlying;
+    }
+
+    template <class T, CodableKind kind>
+    void readKind(T& value, CodableKindConstant<kind>) {
+        readObject(value, std::false_type());
+    }
+
+    //Parsing integer of any signedness
+    bool parseInteger(const JSONSpan& span, long long& value);
+    bool parseInteger(const JSONSpan& span, unsigned long long& value);
+
+    //Decoding closure to fields of class with plan
+    template <class T>
+    void readObject(T& value, std::true_type) {
+        if (beginNested('{')) {
+            readFields(plan<T>(), &value);
+        }
+    }
+
+    //Decoding value of other type from its text by generic decoder
+    template <class T>
+    void readObject(T& value, std::false_type) {
+        JSONSpan span;
+        if (readText(span)) {
+            fallback.parse(text + span.offset, span.length)->decodeTo(value);
+        }
+    }
+
+    void begin(const char* text, unsigned long length);
+    //Getting position of the next structural character without moving to it, returns false at the end of text
+    bool peek(unsigned long& position);
+    //Moving to the next structural character, returns false at the end of text
+    bool next(unsigned long& position);
+    //Reading the next value if it is not closure or array, returns false for them (they are skipped) and empty values
+    bool beginScalar(JSONSpan& span);
+    //Moving into closure or array with specific bracket, other values are skipped and false is returned
+    bool beginNested(char bracket);
+    //Moving after closing bracket of empty closure or array, returns false if it isn't empty
+    bool closes(char bracket);
+    //Reading structural character after value
+    void readTerminator();
+    //Skipping the rest of closure or array after its opening bracket, returns position of closing bracket
+    unsigned long skipNested();
+    //Reading text of the next value of any type
+    bool readText(JSONSpan& span);
+    //Decoding fields of closure after its opening bracket
+    void readFields(const JSONDecodePlan& plan, void* object);
+};
+
+#endif
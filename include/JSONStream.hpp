@@ -0,0 +1,239 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include "Arena.hpp"
+#include "JSON.hpp"
+#include "JSONParser.hpp"
+#include "JSONStructural.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+//Splitter of JSON array that arrives by chunks (for example, from socket) into texts of its elements
+//Chunks are scanned once with structural scanner, state of strings and escapes is carried between them,
+//numbers and other values are kept until their separator arrives. Only text of unfinished element is kept,
+//so memory doesn't depend on size of the whole array.
+//Up to 63 bytes of chunk wait for the next chunk or finish(), because scanner processes text by blocks of 64 bytes.
+//Consists of:
+// scanner - scanner of structural characters
+// tape - positions of structural characters of scanned piece
+// buffer - received text that isn't processed yet (it starts from unfinished element)
+// scanned - count of bytes of buffer that are already scanned
+// elementStart - position of unfinished element in buffer
+// depth - nesting depth at the end of scanned text (1 inside of the highest array)
+// state - position in the highest array (before it, inside of it, after it or malformed text)
+class JSONArrayStream {
+public:
+    JSONArrayStream();
+    virtual ~JSONArrayStream() {}
+
+    //Adding the next chunk of text, returns false if text isn't an array
+    //Elements that are finished in this chunk are passed to element() before return
+    bool feed(const char* data, unsigned long length);
+    //Ending text, returns false if array isn't finished or text is malformed
+    bool finish();
+    //Starting the next text, buffers are kept
+    void reset();
+
+    //Checking if the highest array is closed
+    bool isFinished() const {
+        return state == State::after;
+    }
+
+protected:
+    //Called with text of every element of the highest array as soon as it is received (without surrounding whitespaces)
+    //Text is valid only during the call
+    virtual void element(const char* text, unsigned long length) = 0;
+
+private:
+    enum class State {
+        before,
+        inside,
+        after,
+        malformed
+    };
+
+    JSONStructuralScanner scanner;
+    std::vector<unsigned> tape;
+    std::string buffer;
+    unsigned long scanned;
+    unsigned long elementStart;
+    int depth;
+    State state;
+
+    //Scanning buffer from scanned position, length must be multiple of 64 unless it is the end of text
+    void scan(unsigned long length);
+    //Processing of structural character of buffer
+    void structural(unsigned long position);
+    //Passing text of element to element() if it isn't empty
+    void emit(unsigned long end);
+};
+
+//Push-style decoder of JSON array
+//Every element of the highest array is decoded to T as soon as it is received and passed to callback,
+//so large documents are processed while the rest of them is still arriving.
+//Elements are decoded with one decoder which is reset after every element.
+template <class T>
+class JSONStreamDecoder: public JSONArrayStream {
+public:
+    JSONStreamDecoder(std::function<void(T&)> callback) {
+        this->callback = callback;
+    }
+
+private:
+    std::function<void(T&)> callback;
+    JSONDecoder decoder;
+
+    void element(const char* text, unsigned long length) {
+        T value = T();
+        JSONDecodeContainer container = decoder.container(text, length);
+        container.decodeTo(value);
+        decoder.reset();
+        callback(value);
+    }
+};
+
+//Reader of elements of JSON array one by one
+//Elements of parsed array are taken from its children. Elements of array that isn't expanded (or given as text)
+//are found with structural scanner and parsed one by one to the same arena, so memory doesn't depend on count of them.
+//Consists of:
+// array - parsed array (NULL if array is read from text)
+// index - index of the next child of parsed array
+// text - text of array with brackets
+// length - length of text
+// scanner - scanner of structural characters
+// tape - positions of structural characters of current window
+// scanned - count of scanned characters of text
+// windowStart - position of current window in text
+// tapeIndex - index of the next structural character in tape
+// tapeCount - count of structural characters in tape
+// elementStart - position of the next element in text
+// depth - nesting depth at the last processed structural character
+// arena - storage of containers of current element, it is reset before every element
+// parser - parser of elements
+class JSONElementReader {
+public:
+    JSONElementReader(JSONDecodeContainer* array);
+    JSONElementReader(const char* text, unsigned long length);
+
+    //Getting container of the next element, returns NULL at the end of array
+    //Container is valid until the next call
+    JSONDecodeContainer* next();
+
+    //Finding text of the next element (relative to text of array) without parsing, returns false at the end of array
+    //Applicable only for arrays that are read from text
+    bool nextSpan(JSONSpan& span);
+
+    JSONElementReader(const JSONElementReader&) = delete;
+    JSONElementReader& operator=(const JSONElementReader&) = delete;
+
+private:
+    JSONDecodeContainer* array;
+    unsigned long index;
+    const char* text;
+    unsigned long length;
+    JSONStructuralScanner scanner;
+    std::vector<unsigned> tape;
+    unsigned long scanned;
+    unsigned long windowStart;
+    unsigned long tapeIndex;
+    unsigned long tapeCount;
+    unsigned long elementStart;
+    int depth;
+    Arena arena;
+    JSONParser parser;
+
+    //Getting position of the next structural character, returns false at the end of text
+    bool nextStructural(unsigned long& position);
+};
+
+//Range of elements of JSON array that are decoded to T one by one
+//It is single-pass range: begin() may be called once, value of previous element is replaced by the next one.
+//Every element is decoded to default value of T, so fields that are missing in one element aren't taken from previous one.
+//  for (const Contact& contact : container.elements<Contact>("contacts")) {...}
+//Consists of:
+// reader - reader of elements
+// value - value of current element
+template <class T>
+class JSONElements {
+public:
+    class iterator {
+    public:
+        iterator(JSONElements* range) {
+            this->range = range;
+        }
+
+        T& operator *() const {
+            return range->value;
+        }
+
+        T* operator ->() const {
+            return &range->value;
+        }
+
+        iterator& operator ++() {
+            if (!range->advance()) {
+                range = NULL;
+            }
+            return *this;
+        }
+
+        bool operator ==(const iterator& other) const {
+            return range == other.range;
+        }
+
+        bool operator !=(const iterator& other) const {
+            return range != other.range;
+        }
+
+    private:
+        JSONElements* range;
+    };
+
+    //Range of elements of parsed container (empty if container is NULL)
+    JSONElements(JSONDecodeContainer* array) {
+        this->reader = array != NULL ? new JSONElementReader(array) : NULL;
+    }
+
+    //Range of elements of array text, text must outlive range
+    JSONElements(const char* text, unsigned long length) {
+        this->reader = new JSONElementReader(text, length);
+    }
+
+    JSONElements(JSONElements&& range) : value(std::move(range.value)) {
+        this->reader = range.reader;
+        range.reader = NULL;
+    }
+
+    ~JSONElements() {
+        delete reader;
+    }
+
+    iterator begin() {
+        return advance() ? iterator(this) : iterator(NULL);
+    }
+
+    iterator end() {
+        return iterator(NULL);
+    }
+
+    JSONElements(const JSONElements&) = delete;
+    JSONElements& operator=(const JSONElements&) = delete;
+
+private:
+    JSONElementReader* reader;
+    T value;
+
+    //Decoding the next element, returns false at the end of array
+    bool advance() {
+        JSONDecodeContainer* element = reader != NULL ? reader->next() : NULL;
+        if (element == NULL) {
+            return false;
+        }
+        value = T();
+        element->decodeTo(value);
+        return true;
+    }
+};
+
+#endif
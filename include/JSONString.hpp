@@ -0,0 +1,19 @@
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <string>
+
+//Escaping and unescaping of JSON strings (RFC 8259)
+//Quote, backslash and control characters are escaped, other characters are written as UTF-8.
+//Both directions check UTF-8: invalid sequences (and lone surrogates in \u escapes) are replaced with U+FFFD,
+//so output is always valid UTF-8. Runs of characters that don't need any work are found with SIMD
+//(16 bytes at once) and copied in bulk, so mostly ASCII text costs about the same as plain copying.
+
+//Appending escaped text (without quotes) to output, returns false if invalid UTF-8 was replaced
+bool jsonEscape(const char* text, unsigned long length, std::string& output);
+
+//Appending unescaped text of string (without quotes) to output, returns false if something was replaced
+//Unknown and incomplete escapes are copied as they are
+bool jsonUnescape(const char* text, unsigned long length, std::string& output);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef JSON_STRUCTURAL_H
+#define JSON_STRUCTURAL_H
+
+//Finding of structural characters ({, }, [, ], : and ,) outside of strings
+//Text is classified by blocks of 64 bytes: masks of quotes, backslashes and structural characters are built with SIMD,
+//escaped quotes are removed from quote mask and the mask of string bytes is got as prefix XOR of quote mask.
+//Implementation is chosen at runtime: AVX2 (with carry-less multiplication for prefix XOR), SSE2 or scalar one.
+
+//Implementations of scanner
+enum class JSONScanLevel {
+    scalar,
+    sse2,
+    avx2
+};
+
+//The fastest implementation supported by current processor
+JSONScanLevel jsonBestScanLevel();
+//Checking if implementation is supported by current processor
+bool jsonScanLevelSupported(JSONScanLevel level);
+
+//Scanner of structural characters
+//Text can be scanned by pieces, state of strings and escapes is carried between them.
+//Consists of:
+// level - used implementation
+// inString - all ones if previous piece ended inside of string, zero otherwise
+// escaped - 1 if the first character of the next piece is escaped by backslash
+class JSONStructuralScanner {
+public:
+    JSONStructuralScanner();
+    JSONStructuralScanner(JSONScanLevel level);
+
+    //Starting new text
+    void begin();
+
+    //Scanning the next piece of text, its length must be multiple of 64 unless it is the last piece
+    //Positions of structural characters (relative to data) are written to positions,
+    //which must have space for length values. Returns count of found characters.
+    unsigned long scan(const char* data, unsigned long length, unsigned* positions);
+
+    JSONScanLevel scanLevel() const {
+        return level;
+    }
+
+private:
+    JSONScanLevel level;
+    unsigned long long inString;
+    unsigned long long escaped;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Pool of threads with work stealing
+//Range of work is split into chunks which are spread between deques of workers. Every worker takes chunks
+//from the back of its own deque and steals from the front of deques of other workers when its deque is empty,
+//so threads that got cheap chunks help the ones that got expensive chunks.
+//Calling thread works as worker 0 during parallelFor(), so pool of 1 thread runs everything in calling thread.
+//Consists of:
+// threads - started worker threads (workers 1...size()-1)
+// queues - deques of chunks of every worker
+// job - function of current parallelFor() call
+// remaining - count of chunks of current call that aren't finished
+// generation - count of parallelFor() calls, sleeping workers wake up when it changes
+// stopping - true when pool is destroyed
+class CodableThreadPool {
+public:
+    //Pool with specific count of workers including calling thread (0 - count of hardware threads)
+    CodableThreadPool(unsigned threads = 0);
+    ~CodableThreadPool();
+
+    //Count of workers including calling thread
+    unsigned size() const {
+        return (unsigned)queues.size();
+    }
+
+    //Running function for range [0, count) split to chunks of grain size, returns when all chunks are finished
+    //Function gets index of worker (less than size()) and range of chunk. Calls from several threads are serialized,
+    //nested calls from function aren't supported.
+    void parallelFor(unsigned long count, unsigned long grain, const std::function<void(unsigned, unsigned long, unsigned long)>& function);
+
+    CodableThreadPool(const CodableThreadPool&) = delete;
+    CodableThreadPool& operator=(const CodableThreadPool&) = delete;
+
+private:
+    //Range of chunk
+    struct Chunk {
+        unsigned long begin;
+        unsigned long end;
+    };
+
+    //Deque of chunks of one worker
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<Queue*> queues;
+    const std::function<void(unsigned, unsigned long, unsigned long)>* job;
+    std::atomic<unsigned long> remaining;
+    unsigned long generation;
+    bool stopping;
+    //Mutex and condition for waking workers and for waiting for the end of call
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    //Serializing of parallelFor() calls
+    std::mutex callMutex;
+
+    void workerLoop(unsigned index);
+    //Running chunks of own deque and stolen ones until there are no chunks
+    void work(unsigned index);
+    bool pop(unsigned index, Chunk& chunk);
+    bool steal(unsigned index, Chunk& chunk);
+};
+
+#endif
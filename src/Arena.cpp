@@ -0,0 +1,50 @@
+#include "Arena.hpp"
+#include <vector>
+
+using namespace std;
+
+Arena::Arena(unsigned long blockSize) {
+    this->blockSize = blockSize;
+    this->current = -1;
+    this->position = 0;
+}
+
+Arena::~Arena() {
+    release();
+}
+
+void* Arena::allocateInNextBlock(unsigned long size, unsigned long alignment) {
+    unsigned long next = current + 1;
+    //Blocks left after reset are reused, new block is inserted if the next one is too small
+    if (next >= blocks.size() || blocks[next].size < size + alignment) {
+        Block block;
+        block.size = size + alignment > blockSize ? size + alignment : blockSize;
+        block.data = new char[block.size];
+        blocks.insert(blocks.begin() + next, block);
+    }
+    current = next;
+    position = 0;
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    current = blocks.empty() ? -1 : 0;
+    position = 0;
+}
+
+void Arena::release() {
+    for (unsigned long i = 0; i < blocks.size(); i++) {
+        delete[] blocks[i].data;
+    }
+    blocks.clear();
+    current = -1;
+    position = 0;
+}
+
+unsigned long Arena::capacity() const {
+    unsigned long result = 0;
+    for (unsigned long i = 0; i < blocks.size(); i++) {
+        result += blocks[i].size;
+    }
+    return result;
+}
@@ -0,0 +1,355 @@
+#include "Codable.hpp"
+#include "Binary.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+//Size of output that is collected before flushing it to sink
+const unsigned long binarySinkBufferSize = 1 << 16;
+//Size of closure length
+const unsigned long closureLengthSize = 4;
+
+//Zigzag encoding maps small negative numbers to small unsigned ones (0, -1, 1, -2... to 0, 1, 2, 3...)
+static inline unsigned long long zigzagEncode(long long value) {
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static inline long long zigzagDecode(unsigned long long value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+BinaryEncodeContainer::BinaryEncodeContainer() {
+    this->type = CoderType::binary;
+    this->root = NULL;
+    this->sink = NULL;
+    this->openClosures = 0;
+    this->closureLimit = numeric_limits<uint32_t>::max();
+    this->overflowed = false;
+}
+
+BinaryEncodeContainer::BinaryEncodeContainer(CoderSink* sink) : BinaryEncodeContainer::BinaryEncodeContainer() {
+    this->sink = sink;
+}
+
+BinaryEncodeContainer::BinaryEncodeContainer(BinaryEncodeContainer* parent) : BinaryEncodeContainer::BinaryEncodeContainer() {
+    this->root = parent->top();
+}
+
+void BinaryEncodeContainer::begin() {
+    if (root == NULL) {
+        content.clear();
+        openClosures = 0;
+        overflowed = false;
+    }
+}
+
+bool BinaryEncodeContainer::end() {
+    if (root == NULL) {
+        //Invalid document isn't returned or written
+        if (overflowed) {
+            content.clear();
+            return false;
+        }
+        flush(true);
+    }
+    return true;
+}
+
+void BinaryEncodeContainer::setClosureLimit(unsigned long long limit) {
+    closureLimit = min(limit, (unsigned long long)numeric_limits<uint32_t>::max());
+}
+
+void BinaryEncodeContainer::reset() {
+    begin();
+}
+
+void BinaryEncodeContainer::flush(bool force) {
+    BinaryEncodeContainer* top = this->top();
+    if (top->sink == NULL || top->openClosures > 0 || top->overflowed) {
+        return;
+    }
+    string& data = top->content;
+    if (data.length() >= binarySinkBufferSize || (force && data.length())) {
+        top->sink->write(data.data(), data.length());
+        data.clear();
+    }
+}
+
+void BinaryEncodeContainer::writeVarint(unsigned long long value) {
+    char buffer[10];
+    int length = 0;
+    while (value >= 0x80) {
+        buffer[length++] = (char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[length++] = (char)value;
+    data().append(buffer, length);
+}
+
+unsigned long BinaryEncodeContainer::openClosure() {
+    string& data = this->data();
+    unsigned long position = data.length();
+    data.append(closureLengthSize, '\0');
+    top()->openClosures++;
+    return position;
+}
+
+void BinaryEncodeContainer::closeClosure(unsigned long position) {
+    string& data = this->data();
+    unsigned long long fieldsLength = data.length() - position - closureLengthSize;
+    //Length that doesn't fit makes the whole document invalid, it isn't truncated silently
+    if (fieldsLength > top()->closureLimit) {
+        top()->overflowed = true;
+    }
+    uint32_t length = (uint32_t)fieldsLength;
+    for (unsigned long i = 0; i < closureLengthSize; i++) {
+        data[position + i] = (char)(length >> (8 * i));
+    }
+    top()->openClosures--;
+}
+
+void BinaryEncodeContainer::encode(bool value, CodingKey key) {
+    data() += value ? '\1' : '\0';
+}
+
+void BinaryEncodeContainer::encode(int value, CodingKey key) {
+    writeVarint(zigzagEncode(value));
+}
+
+void BinaryEncodeContainer::encode(long long value, CodingKey key) {
+    writeVarint(zigzagEncode(value));
+}
+
+void BinaryEncodeContainer::encode(unsigned long long value, CodingKey key) {
+    writeVarint(value);
+}
+
+void BinaryEncodeContainer::encode(float value, CodingKey key) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    char buffer[4];
+    for (int i = 0; i < 4; i++) {
+        buffer[i] = (char)(bits >> (8 * i));
+    }
+    data().append(buffer, 4);
+}
+
+void BinaryEncodeContainer::encode(double value, CodingKey key) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    char buffer[8];
+    for (int i = 0; i < 8; i++) {
+        buffer[i] = (char)(bits >> (8 * i));
+    }
+    data().append(buffer, 8);
+}
+
+void BinaryEncodeContainer::encode(const string& value, CodingKey key, bool withQuotes) {
+    encode(value.data(), value.length(), key, withQuotes);
+}
+
+void BinaryEncodeContainer::encode(const char* value, CodingKey key, bool withQuotes) {
+    encode(value, strlen(value), key, withQuotes);
+}
+
+void BinaryEncodeContainer::encode(const char* value, unsigned long length, CodingKey key, bool withQuotes) {
+    writeVarint(length);
+    data().append(value, length);
+}
+
+BinaryDecodeContainer::BinaryDecodeContainer(const char* source, unsigned long position, unsigned long end) {
+    this->type = CoderType::binary;
+    this->source = source;
+    this->position = position;
+    this->end = end;
+}
+
+bool BinaryDecodeContainer::readVarint(unsigned long long& value) {
+    unsigned long long result = 0;
+    for (int shift = 0; position < end && shift < 64; shift += 7) {
+        unsigned char byte = source[position++];
+        result |= (unsigned long long)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = result;
+            return true;
+        }
+    }
+    //Malformed data, nothing else can be read from container
+    position = end;
+    return false;
+}
+
+bool BinaryDecodeContainer::readClosure(BinaryDecodeContainer& closure) {
+    if (end - position < closureLengthSize || atEnd()) {
+        position = end;
+        return false;
+    }
+    unsigned long length = 0;
+    for (unsigned long i = 0; i < closureLengthSize; i++) {
+        length |= (unsigned long)(unsigned char)source[position + i] << (8 * i);
+    }
+    position += closureLengthSize;
+    if (length > end - position) {
+        position = end;
+        return false;
+    }
+    closure.position = position;
+    closure.end = position + length;
+    //Fields that weren't decoded are skipped
+    position += length;
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(bool& value, CodingKey key) {
+    if (atEnd()) {
+        return false;
+    }
+    value = source[position++] != 0;
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(int& value, CodingKey key) {
+    unsigned long long result;
+    if (!readVarint(result)) {
+        return false;
+    }
+    long long decoded = zigzagDecode(result);
+    if (decoded < numeric_limits<int>::min() || decoded > numeric_limits<int>::max()) {
+        return false;
+    }
+    value = (int)decoded;
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(long long& value, CodingKey key) {
+    unsigned long long result;
+    if (!readVarint(result)) {
+        return false;
+    }
+    value = zigzagDecode(result);
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(unsigned long long& value, CodingKey key) {
+    return readVarint(value);
+}
+
+bool BinaryDecodeContainer::decodeTo(float& value, CodingKey key) {
+    if (end - position < 4 || atEnd()) {
+        position = end;
+        return false;
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; i++) {
+        bits |= (uint32_t)(unsigned char)source[position + i] << (8 * i);
+    }
+    memcpy(&value, &bits, sizeof(value));
+    position += 4;
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(double& value, CodingKey key) {
+    if (end - position < 8 || atEnd()) {
+        position = end;
+        return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits |= (uint64_t)(unsigned char)source[position + i] << (8 * i);
+    }
+    memcpy(&value, &bits, sizeof(value));
+    position += 8;
+    return true;
+}
+
+bool BinaryDecodeContainer::decodeTo(string& value, CodingKey key, bool withQuotes) {
+    unsigned long long length;
+    if (!readVarint(length)) {
+        return false;
+    }
+    if (length > end - position) {
+        position = end;
+        return false;
+    }
+    value.assign(source + position, length);
+    position += length;
+    return true;
+}
+
+bool BinaryDecodeContainer::decode(bool type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+int BinaryDecodeContainer::decode(int type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+long long BinaryDecodeContainer::decode(long long type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+float BinaryDecodeContainer::decode(float type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+double BinaryDecodeContainer::decode(double type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+string BinaryDecodeContainer::decode(string type, CodingKey key, bool withQuotes) {
+    decodeTo(type, key, withQuotes);
+    return type;
+}
+
+BinaryEncodeContainer BinaryEncoder::container() {
+    return BinaryEncodeContainer();
+}
+
+BinaryEncodeContainer BinaryEncoder::container(CoderSink* sink) {
+    return BinaryEncodeContainer(sink);
+}
+
+BinaryDecoder::BinaryDecoder() {
+    this->usedBuffers = 0;
+}
+
+string& BinaryDecoder::nextBuffer() {
+    if (usedBuffers == buffers.size()) {
+        buffers.push_back(string());
+    }
+    return buffers[usedBuffers++];
+}
+
+BinaryDecodeContainer BinaryDecoder::lastBuffer() {
+    const string& buffer = buffers[usedBuffers - 1];
+    return BinaryDecodeContainer(buffer.data(), 0, buffer.length());
+}
+
+BinaryDecodeContainer BinaryDecoder::container(const string& content) {
+    nextBuffer().assign(content);
+    return lastBuffer();
+}
+
+BinaryDecodeContainer BinaryDecoder::container(const char* content, unsigned long length) {
+    nextBuffer().assign(content, length);
+    return lastBuffer();
+}
+
+BinaryDecodeContainer BinaryDecoder::container(string&& content) {
+    nextBuffer().swap(content);
+    content.clear();
+    return lastBuffer();
+}
+
+void BinaryDecoder::reset() {
+    usedBuffers = 0;
+}
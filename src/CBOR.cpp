@@ -0,0 +1,720 @@
+#include "Codable.hpp"
+#include "CBOR.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+//Size of output that is collected before flushing it to sink
+const unsigned long cborSinkBufferSize = 1 << 16;
+//Maximal nesting of data items that are skipped, deeper data is treated as malformed
+const int cborMaxDepth = 512;
+
+//Major types
+const unsigned char cborUnsigned = 0;
+const unsigned char cborNegative = 1;
+const unsigned char cborBytes = 2;
+const unsigned char cborText = 3;
+const unsigned char cborArray = 4;
+const unsigned char cborMap = 5;
+const unsigned char cborTag = 6;
+const unsigned char cborSimple = 7;
+//Major type of malformed data item
+const unsigned char cborMalformed = 8;
+//Additional information of indefinite length
+const unsigned char cborIndefinite = 31;
+
+//Converting float to half precision number if it can be done without losing precision
+static bool toHalf(float value, uint16_t& half) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    int exponent = (int)((bits >> 23) & 0xFF);
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent == 0xFF) {
+        //Infinity (NaN is written separately)
+        if (mantissa != 0) {
+            return false;
+        }
+        half = sign | 0x7C00;
+        return true;
+    }
+    if (exponent == 0) {
+        //Only zero, subnormal floats are too small for half precision
+        if (mantissa != 0) {
+            return false;
+        }
+        half = sign;
+        return true;
+    }
+    int power = exponent - 127;
+    if (power >= -14 && power <= 15) {
+        if (mantissa & 0x1FFF) {
+            return false;
+        }
+        half = sign | (uint16_t)((power + 15) << 10) | (uint16_t)(mantissa >> 13);
+        return true;
+    }
+    if (power < -14 && power >= -24) {
+        //Subnormal half: value is m * 2^-24
+        uint32_t full = mantissa | 0x800000;
+        int shift = -power - 1;
+        if (full & ((1u << shift) - 1)) {
+            return false;
+        }
+        half = sign | (uint16_t)(full >> shift);
+        return true;
+    }
+    return false;
+}
+
+static double fromHalf(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    double value;
+    if (exponent == 0) {
+        value = ldexp((double)mantissa, -24);
+    } else if (exponent != 31) {
+        value = ldexp((double)(mantissa + 1024), exponent - 25);
+    } else {
+        value = mantissa == 0 ? numeric_limits<double>::infinity() : numeric_limits<double>::quiet_NaN();
+    }
+    return half & 0x8000 ? -value : value;
+}
+
+CBOREncodeContainer::CBOREncodeContainer() {
+    this->type = CoderType::cbor;
+    this->output = NULL;
+    this->sink = NULL;
+}
+
+CBOREncodeContainer::CBOREncodeContainer(CoderSink* sink) : CBOREncodeContainer::CBOREncodeContainer() {
+    this->sink = sink;
+}
+
+CBOREncodeContainer::CBOREncodeContainer(CBOREncodeContainer* parent) : CBOREncodeContainer::CBOREncodeContainer() {
+    this->output = &parent->data();
+    this->sink = parent->sink;
+}
+
+void CBOREncodeContainer::begin() {
+    if (output == NULL) {
+        content.clear();
+    }
+}
+
+void CBOREncodeContainer::end() {
+    if (output == NULL) {
+        flush(true);
+    }
+}
+
+void CBOREncodeContainer::reset() {
+    begin();
+}
+
+void CBOREncodeContainer::flush(bool force) {
+    if (sink == NULL) {
+        return;
+    }
+    string& data = this->data();
+    if (data.length() >= cborSinkBufferSize || (force && data.length())) {
+        sink->write(data.data(), data.length());
+        data.clear();
+    }
+}
+
+void CBOREncodeContainer::writeHead(unsigned char major, unsigned long long argument) {
+    char buffer[9];
+    int length;
+    major <<= 5;
+    if (argument < 24) {
+        buffer[0] = (char)(major | argument);
+        length = 1;
+    } else {
+        //Argument is written in big-endian order with 1, 2, 4 or 8 bytes
+        int size = argument <= 0xFF ? 1 : (argument <= 0xFFFF ? 2 : (argument <= 0xFFFFFFFFULL ? 4 : 8));
+        buffer[0] = (char)(major | (size == 1 ? 24 : (size == 2 ? 25 : (size == 4 ? 26 : 27))));
+        for (int i = 0; i < size; i++) {
+            buffer[1 + i] = (char)(argument >> (8 * (size - 1 - i)));
+        }
+        length = 1 + size;
+    }
+    data().append(buffer, length);
+}
+
+void CBOREncodeContainer::writeKey(const CodingKey& key) {
+    if (key.length) {
+        writeHead(cborText, key.length);
+        data().append(key.data, key.length);
+    }
+}
+
+//Writing floating point number in the shortest form without losing precision
+void CBOREncodeContainer::writeFloating(double value) {
+    char buffer[9];
+    int length;
+    uint16_t half;
+    if (value != value) {
+        //The only NaN in preferred serialization
+        buffer[0] = (char)0xF9;
+        buffer[1] = (char)0x7E;
+        buffer[2] = 0;
+        length = 3;
+    } else if (isinf(value) || (fabs(value) <= numeric_limits<float>::max() && (double)(float)value == value)) {
+        float single = (float)value;
+        if (toHalf(single, half)) {
+            buffer[0] = (char)0xF9;
+            buffer[1] = (char)(half >> 8);
+            buffer[2] = (char)half;
+            length = 3;
+        } else {
+            uint32_t bits;
+            memcpy(&bits, &single, sizeof(bits));
+            buffer[0] = (char)0xFA;
+            for (int i = 0; i < 4; i++) {
+                buffer[1 + i] = (char)(bits >> (8 * (3 - i)));
+            }
+            length = 5;
+        }
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        buffer[0] = (char)0xFB;
+        for (int i = 0; i < 8; i++) {
+            buffer[1 + i] = (char)(bits >> (8 * (7 - i)));
+        }
+        length = 9;
+    }
+    data().append(buffer, length);
+}
+
+void CBOREncodeContainer::encode(bool value, CodingKey key) {
+    writeKey(key);
+    data() += (char)(value ? 0xF5 : 0xF4);
+}
+
+void CBOREncodeContainer::encode(int value, CodingKey key) {
+    encode((long long)value, key);
+}
+
+void CBOREncodeContainer::encode(long long value, CodingKey key) {
+    writeKey(key);
+    if (value >= 0) {
+        writeHead(cborUnsigned, (unsigned long long)value);
+    } else {
+        //Negative integer n is written as -1 - n
+        writeHead(cborNegative, (unsigned long long)(-1 - value));
+    }
+}
+
+void CBOREncodeContainer::encode(unsigned long long value, CodingKey key) {
+    writeKey(key);
+    writeHead(cborUnsigned, value);
+}
+
+void CBOREncodeContainer::writeNull() {
+    data() += (char)0xF6;
+}
+
+void CBOREncodeContainer::encode(float value, CodingKey key) {
+    writeKey(key);
+    writeFloating(value);
+}
+
+void CBOREncodeContainer::encode(double value, CodingKey key) {
+    writeKey(key);
+    writeFloating(value);
+}
+
+void CBOREncodeContainer::encode(const string& value, CodingKey key, bool withQuotes) {
+    encode(value.data(), value.length(), key, withQuotes);
+}
+
+void CBOREncodeContainer::encode(const char* value, CodingKey key, bool withQuotes) {
+    encode(value, strlen(value), key, withQuotes);
+}
+
+void CBOREncodeContainer::encode(const char* value, unsigned long length, CodingKey key, bool withQuotes) {
+    writeKey(key);
+    writeHead(cborText, length);
+    data().append(value, length);
+}
+
+CBORDecodeContainer::CBORDecodeContainer() {
+    this->type = CoderType::cbor;
+    this->source = NULL;
+    this->length = 0;
+    this->offset = 0;
+    this->major = cborMalformed;
+    this->itemsOffset = 0;
+    this->itemsCount = 0;
+    this->end = 0;
+    this->cursor = 0;
+    this->cursorIndex = 0;
+    this->cursorEnd = 0;
+}
+
+CBORDecodeContainer::CBORDecodeContainer(const char* source, unsigned long length, unsigned long offset) : CBORDecodeContainer::CBORDecodeContainer() {
+    this->source = source;
+    this->length = length;
+    this->offset = offset;
+
+    unsigned long position = offset;
+    unsigned char info;
+    unsigned long long argument;
+    if (!readHead(position, major, info, argument)) {
+        major = cborMalformed;
+        return;
+    }
+    //Tags are skipped, the value of tagged data item is decoded
+    while (major == cborTag) {
+        this->offset = position;
+        if (!readHead(position, major, info, argument)) {
+            major = cborMalformed;
+            return;
+        }
+    }
+    if (major == cborArray || major == cborMap) {
+        itemsOffset = position;
+        itemsCount = info == cborIndefinite ? indefinite : argument;
+        cursor = itemsOffset;
+    }
+}
+
+bool CBORDecodeContainer::readHead(unsigned long& position, unsigned char& major, unsigned char& info, unsigned long long& argument) const {
+    if (position >= length) {
+        return false;
+    }
+    unsigned char initial = (unsigned char)source[position++];
+    major = initial >> 5;
+    info = initial & 0x1F;
+    if (info < 24) {
+        argument = info;
+        return true;
+    }
+    if (info == cborIndefinite) {
+        //Indefinite length is allowed only for strings, arrays and maps, break byte is handled by callers
+        argument = 0;
+        return major == cborBytes || major == cborText || major == cborArray || major == cborMap || major == cborSimple;
+    }
+    if (info > 27) {
+        return false;
+    }
+    unsigned long size = 1ul << (info - 24);
+    if (length - position < size) {
+        return false;
+    }
+    argument = 0;
+    for (unsigned long i = 0; i < size; i++) {
+        argument = (argument << 8) | (unsigned char)source[position++];
+    }
+    return true;
+}
+
+bool CBORDecodeContainer::skip(unsigned long& position, int depth) const {
+    if (depth > cborMaxDepth) {
+        return false;
+    }
+    unsigned char major, info;
+    unsigned long long argument;
+    if (!readHead(position, major, info, argument)) {
+        return false;
+    }
+    switch (major) {
+    case cborBytes:
+    case cborText:
+        if (info == cborIndefinite) {
+            //Chunks till break byte
+            while (!isBreak(position)) {
+                if (!skip(position, depth + 1)) {
+                    return false;
+                }
+            }
+            position++;
+            return true;
+        }
+        if (argument > length - position) {
+            return false;
+        }
+        position += argument;
+        return true;
+    case cborArray:
+    case cborMap: {
+        if (info == cborIndefinite) {
+            while (!isBreak(position)) {
+                if (!skip(position, depth + 1)) {
+                    return false;
+                }
+            }
+            position++;
+            return true;
+        }
+        //Every data item takes at least one byte
+        unsigned long long items = major == cborMap ? argument * 2 : argument;
+        if (argument > length - position || items > length - position) {
+            return false;
+        }
+        for (unsigned long long i = 0; i < items; i++) {
+            if (!skip(position, depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case cborTag:
+        return skip(position, depth + 1);
+    case cborSimple:
+        //Break byte outside of indefinite-length item is malformed
+        return info != cborIndefinite;
+    default:
+        return true;
+    }
+}
+
+bool CBORDecodeContainer::readKey(unsigned long& position, const CodingKey& key, bool& matches) const {
+    unsigned long keyPosition = position;
+    unsigned char keyMajor, info;
+    unsigned long long argument;
+    if (!readHead(position, keyMajor, info, argument)) {
+        return false;
+    }
+    if (keyMajor == cborText && info != cborIndefinite) {
+        if (argument > length - position) {
+            return false;
+        }
+        matches = argument == key.length && memcmp(source + position, key.data, key.length) == 0;
+        position += argument;
+        return true;
+    }
+    //Keys of other types are never matched
+    matches = false;
+    position = keyPosition;
+    return skip(position);
+}
+
+bool CBORDecodeContainer::find(CodingKey key, CBORDecodeContainer& value) {
+    if (major != cborMap) {
+        return false;
+    }
+    unsigned long position = cursor;
+    unsigned long long index = cursorIndex;
+    bool matches;
+    if (cursorEnd != 0) {
+        //Value of the last found entry is already decoded, so it isn't skipped again
+        if (!readKey(position, key, matches)) {
+            return false;
+        }
+        if (matches) {
+            value = CBORDecodeContainer(source, length, position);
+            return value.major != cborMalformed;
+        }
+        position = cursorEnd;
+        index++;
+    }
+    //Scanning from the last found entry to the end of map, then from the beginning to the last found entry
+    for (int pass = 0; pass < 2; pass++) {
+        unsigned long stop = pass == 0 ? length : cursor;
+        while (position < stop && (itemsCount == indefinite ? !isBreak(position) : index < itemsCount)) {
+            unsigned long keyPosition = position;
+            if (!readKey(position, key, matches)) {
+                return false;
+            }
+            if (matches) {
+                //Value isn't skipped here, its end is known after it is decoded
+                cursor = keyPosition;
+                cursorIndex = index;
+                cursorEnd = 0;
+                value = CBORDecodeContainer(source, length, position);
+                return value.major != cborMalformed;
+            }
+            if (!skip(position)) {
+                return false;
+            }
+            index++;
+        }
+        if (pass == 0) {
+            position = itemsOffset;
+            index = 0;
+        }
+    }
+    return false;
+}
+
+CBORDecodeContainer* CBORDecodeContainer::target(CodingKey key, CBORDecodeContainer& found) {
+    if (key.empty()) {
+        return this;
+    }
+    return find(key, found) ? &found : NULL;
+}
+
+void CBORDecodeContainer::finish(CBORDecodeContainer* item, unsigned long end) {
+    item->end = end;
+    if (item != this) {
+        cursorEnd = end;
+    }
+}
+
+unsigned long CBORDecodeContainer::mapEnd() const {
+    unsigned long position = cursor;
+    unsigned long long index = cursorIndex;
+    if (cursorEnd != 0) {
+        position = cursorEnd;
+        index++;
+    }
+    while (itemsCount == indefinite ? !isBreak(position) : index < itemsCount) {
+        if (position >= length || !skip(position) || !skip(position)) {
+            return 0;
+        }
+        index++;
+    }
+    return itemsCount == indefinite ? position + 1 : position;
+}
+
+bool CBORDecodeContainer::readNumber(double& floating, long long& integer, bool& isInteger, unsigned long& end) const {
+    unsigned long position = offset;
+    unsigned char major, info;
+    unsigned long long argument;
+    if (!readHead(position, major, info, argument)) {
+        return false;
+    }
+    end = position;
+    if (major == cborUnsigned || major == cborNegative) {
+        if (argument > (unsigned long long)numeric_limits<long long>::max()) {
+            return false;
+        }
+        integer = major == cborUnsigned ? (long long)argument : -1 - (long long)argument;
+        floating = (double)integer;
+        isInteger = true;
+        return true;
+    }
+    if (major != cborSimple || info < 25 || info > 27) {
+        return false;
+    }
+    if (info == 25) {
+        floating = fromHalf((uint16_t)argument);
+    } else if (info == 26) {
+        uint32_t bits = (uint32_t)argument;
+        float single;
+        memcpy(&single, &bits, sizeof(single));
+        floating = single;
+    } else {
+        uint64_t bits = argument;
+        memcpy(&floating, &bits, sizeof(floating));
+    }
+    isInteger = false;
+    return true;
+}
+
+bool CBORDecodeContainer::decodeTo(bool& value, CodingKey key) {
+    CBORDecodeContainer found;
+    CBORDecodeContainer* item = target(key, found);
+    if (item == NULL || item->offset >= length) {
+        return false;
+    }
+    unsigned char initial = (unsigned char)source[item->offset];
+    if (initial != 0xF4 && initial != 0xF5) {
+        return false;
+    }
+    value = initial == 0xF5;
+    finish(item, item->offset + 1);
+    return true;
+}
+
+// !!! Integers are also decoded from floating point numbers, fraction is truncated (like in JSON)
+
+bool CBORDecodeContainer::decodeTo(int& value, CodingKey key) {
+    long long result;
+    if (!decodeTo(result, key) || result < numeric_limits<int>::min() || result > numeric_limits<int>::max()) {
+        return false;
+    }
+    value = (int)result;
+    return true;
+}
+
+bool CBORDecodeContainer::decodeTo(long long& value, CodingKey key) {
+    CBORDecodeContainer found;
+    CBORDecodeContainer* item = target(key, found);
+    double floating;
+    long long integer;
+    bool isInteger;
+    unsigned long end;
+    if (item == NULL || !item->readNumber(floating, integer, isInteger, end)) {
+        return false;
+    }
+    if (!isInteger) {
+        if (!(floating >= -9223372036854775808.0 && floating < 9223372036854775808.0)) {
+            return false;
+        }
+        integer = (long long)floating;
+    }
+    value = integer;
+    finish(item, end);
+    return true;
+}
+
+bool CBORDecodeContainer::decodeTo(unsigned long long& value, CodingKey key) {
+    CBORDecodeContainer found;
+    CBORDecodeContainer* item = target(key, found);
+    if (item == NULL) {
+        return false;
+    }
+    //Unsigned integers are read from argument, so values after the biggest long long are decoded too
+    unsigned long position = item->offset;
+    unsigned char major, info;
+    unsigned long long argument;
+    if (readHead(position, major, info, argument) && major == cborUnsigned) {
+        value = argument;
+        finish(item, position);
+        return true;
+    }
+    long long result;
+    if (!item->decodeTo(result) || result < 0) {
+        return false;
+    }
+    value = (unsigned long long)result;
+    if (item != this) {
+        finish(item, item->end);
+    }
+    return true;
+}
+
+bool CBORDecodeContainer::isNull() const {
+    return offset < length && (unsigned char)source[offset] == 0xF6;
+}
+
+bool CBORDecodeContainer::decodeTo(float& value, CodingKey key) {
+    double result;
+    if (!decodeTo(result, key)) {
+        return false;
+    }
+    value = (float)result;
+    return true;
+}
+
+bool CBORDecodeContainer::decodeTo(double& value, CodingKey key) {
+    CBORDecodeContainer found;
+    CBORDecodeContainer* item = target(key, found);
+    double floating;
+    long long integer;
+    bool isInteger;
+    unsigned long end;
+    if (item == NULL || !item->readNumber(floating, integer, isInteger, end)) {
+        return false;
+    }
+    value = floating;
+    finish(item, end);
+    return true;
+}
+
+bool CBORDecodeContainer::decodeTo(string& value, CodingKey key, bool withQuotes) {
+    CBORDecodeContainer found;
+    CBORDecodeContainer* item = target(key, found);
+    if (item == NULL) {
+        return false;
+    }
+    unsigned long position = item->offset;
+    unsigned char major, info;
+    unsigned long long argument;
+    if (!readHead(position, major, info, argument) || (major != cborText && major != cborBytes)) {
+        return false;
+    }
+    if (info != cborIndefinite) {
+        if (argument > length - position) {
+            return false;
+        }
+        value.assign(source + position, argument);
+        finish(item, position + argument);
+        return true;
+    }
+    //Indefinite-length string is concatenation of definite-length chunks of the same type
+    string result;
+    while (!isBreak(position)) {
+        unsigned char chunkMajor, chunkInfo;
+        if (!readHead(position, chunkMajor, chunkInfo, argument) || chunkMajor != major || chunkInfo == cborIndefinite || argument > length - position) {
+            return false;
+        }
+        result.append(source + position, argument);
+        position += argument;
+    }
+    value.swap(result);
+    finish(item, position + 1);
+    return true;
+}
+
+bool CBORDecodeContainer::decode(bool type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+int CBORDecodeContainer::decode(int type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+long long CBORDecodeContainer::decode(long long type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+float CBORDecodeContainer::decode(float type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+double CBORDecodeContainer::decode(double type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+string CBORDecodeContainer::decode(string type, CodingKey key, bool withQuotes) {
+    decodeTo(type, key, withQuotes);
+    return type;
+}
+
+CBOREncodeContainer CBOREncoder::container() {
+    return CBOREncodeContainer();
+}
+
+CBOREncodeContainer CBOREncoder::container(CoderSink* sink) {
+    return CBOREncodeContainer(sink);
+}
+
+CBORDecoder::CBORDecoder() {
+    this->usedBuffers = 0;
+}
+
+string& CBORDecoder::nextBuffer() {
+    if (usedBuffers == buffers.size()) {
+        buffers.push_back(string());
+    }
+    return buffers[usedBuffers++];
+}
+
+CBORDecodeContainer CBORDecoder::lastBuffer() {
+    const string& buffer = buffers[usedBuffers - 1];
+    return CBORDecodeContainer(buffer.data(), buffer.length(), 0);
+}
+
+CBORDecodeContainer CBORDecoder::container(const string& content) {
+    nextBuffer().assign(content);
+    return lastBuffer();
+}
+
+CBORDecodeContainer CBORDecoder::container(const char* content, unsigned long length) {
+    nextBuffer().assign(content, length);
+    return lastBuffer();
+}
+
+CBORDecodeContainer CBORDecoder::container(string&& content) {
+    nextBuffer().swap(content);
+    content.clear();
+    return lastBuffer();
+}
+
+void CBORDecoder::reset() {
+    usedBuffers = 0;
+}
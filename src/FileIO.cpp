@@ -0,0 +1,144 @@
+#include "FileIO.hpp"
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CODABLE_POSIX_FILES
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <algorithm>
+#include <fstream>
+#include <io.h>
+#include <sstream>
+#endif
+
+using namespace std;
+
+CodableMappedFile::CodableMappedFile() {
+    this->data = "";
+    this->length = 0;
+    this->mapping = NULL;
+}
+
+CodableMappedFile::~CodableMappedFile() {
+    close();
+}
+
+#ifdef CODABLE_POSIX_FILES
+
+bool CodableMappedFile::open(const char* path) {
+    close();
+    int descriptor = ::open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+    //Empty file can't be mapped, it is just empty text
+    if (status.st_size > 0) {
+        void* address = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            ::close(descriptor);
+            return false;
+        }
+        //Parser reads text once from start to end, so system can read ahead and drop pages that are passed
+        madvise(address, status.st_size, MADV_SEQUENTIAL);
+        mapping = address;
+        data = (const char*)address;
+        length = status.st_size;
+    }
+    //Mapping stays valid after descriptor is closed
+    ::close(descriptor);
+    return true;
+}
+
+void CodableMappedFile::close() {
+    if (mapping != NULL) {
+        munmap(mapping, length);
+        mapping = NULL;
+    }
+    data = "";
+    length = 0;
+}
+
+void CodableFileSink::writeAll(const char* data, unsigned long length) {
+    while (length > 0 && !writeFailed) {
+        ssize_t written = ::write(descriptor, data, length);
+        if (written < 0) {
+            writeFailed = errno != EINTR;
+            continue;
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+#else
+
+bool CodableMappedFile::open(const char* path) {
+    close();
+    ifstream file(path, ios::binary);
+    if (!file) {
+        return false;
+    }
+    ostringstream text;
+    text << file.rdbuf();
+    buffer = text.str();
+    data = buffer.data();
+    length = buffer.length();
+    return true;
+}
+
+void CodableMappedFile::close() {
+    buffer.clear();
+    data = "";
+    length = 0;
+}
+
+void CodableFileSink::writeAll(const char* data, unsigned long length) {
+    //Descriptors of C runtime
+    while (length > 0 && !writeFailed) {
+        int written = ::_write(descriptor, data, (unsigned)min(length, 1ul << 30));
+        writeFailed = written <= 0;
+        data += written;
+        length -= written;
+    }
+}
+
+#endif
+
+CodableFileSink::CodableFileSink(int descriptor, unsigned long capacity) {
+    this->descriptor = descriptor;
+    this->buffer.resize(capacity > 0 ? capacity : 1);
+    this->used = 0;
+    this->writeFailed = false;
+}
+
+CodableFileSink::~CodableFileSink() {
+    flush();
+}
+
+void CodableFileSink::write(const char* data, unsigned long length) {
+    if (used + length > buffer.size()) {
+        flush();
+        //Big pieces go to descriptor directly, copying them to buffer saves no calls
+        if (length >= buffer.size()) {
+            writeAll(data, length);
+            return;
+        }
+    }
+    memcpy(buffer.data() + used, data, length);
+    used += length;
+}
+
+bool CodableFileSink::flush() {
+    writeAll(buffer.data(), used);
+    used = 0;
+    return !writeFailed;
+}
@@ -1,342 +1,517 @@
 #include "Codable.hpp"
+#include "FileIO.hpp"
 #include "JSON.hpp"
+#include "JSONKey.hpp"
+#include "JSONNumber.hpp"
+#include "JSONParser.hpp"
+#include "JSONString.hpp"
 #include <vector>
-#include <sstream>
+#include <cstring>
+#include <new>
+#include <limits>
 #include <string>
 
 using namespace std;
 
-JSONEncodeContainer::JSONEncodeContainer(vector<JSONEncodeContainer>* containers) {
+//Size of output that is collected before flushing it to sink
+const unsigned long sinkBufferSize = 1 << 16;
+
+JSONEncodeContainer::JSONEncodeContainer() {
     this->type = CoderType::json;
-    this->containers = containers;
+    this->encodingType = JSONContainerType::closure;
+    this->output = NULL;
+    this->sink = NULL;
+    this->isEmpty = true;
+    this->depth = 0;
+#ifdef CODABLE_ENABLE_STATS
+    this->parentStats = NULL;
+    this->countedLength = 0;
+#endif
+}
+
+JSONEncodeContainer::JSONEncodeContainer(CoderSink* sink) : JSONEncodeContainer::JSONEncodeContainer() {
+    this->sink = sink;
+}
+
+JSONEncodeContainer::JSONEncodeContainer(CoderSink* sink, const JSONFormat& format) : JSONEncodeContainer::JSONEncodeContainer(sink) {
+    this->format = format;
 }
 
-JSONEncodeContainer::JSONEncodeContainer(string key, string content, vector<JSONEncodeContainer>* containers) : JSONEncodeContainer::JSONEncodeContainer(containers) {
-    this->key = key;
-    this->content = content;
+JSONEncodeContainer::JSONEncodeContainer(JSONEncodeContainer* parent, JSONContainerType encodingType) : JSONEncodeContainer::JSONEncodeContainer() {
+    this->encodingType = encodingType;
+    this->output = &parent->text();
+    this->sink = parent->sink;
+    this->format = parent->format;
+    this->depth = parent->depth + 1;
+#ifdef CODABLE_ENABLE_STATS
+    this->parentStats = parent->currentStats();
+#endif
 }
 
-//method for converting container to JSON format
-void JSONEncodeContainer::generateContent() {
-    content = "";
-    //Adding container key if applicable
-    if (key.length()) {
-        content = "\"" + key + "\": ";
+void JSONEncodeContainer::begin() {
+    //The highest container starts new document, nested ones just write value
+    if (output == NULL) {
+        content.clear();
+        isEmpty = true;
+#ifdef CODABLE_ENABLE_STATS
+        countedLength = 0;
+#endif
     }
-    //If container type is variable, then encode its value
-    if (encodingType == JSONContainerType::variable) {
-        content += value;
+}
+
+void JSONEncodeContainer::reset() {
+    if (output == NULL) {
+        content.clear();
+        isEmpty = true;
+#ifdef CODABLE_ENABLE_STATS
+        countedLength = 0;
+#endif
+    }
+}
+
+void JSONEncodeContainer::end() {
+    if (output == NULL) {
+        flush(true);
+        countWritten();
+    }
+}
+
+void JSONEncodeContainer::countWritten() {
+#ifdef CODABLE_ENABLE_STATS
+    //Text that is written to sink is counted by flush(), text that is kept in content is counted once
+    if (output == NULL && sink == NULL) {
+        CODABLE_STAT(currentStats(), bytesWritten, content.length() - countedLength);
+        countedLength = content.length();
+    }
+#endif
+}
+
+void JSONEncodeContainer::flushLines() {
+    end();
+}
+
+void JSONEncodeContainer::flush(bool force) {
+    if (sink == NULL) {
         return;
     }
-    //If container type is array, then add array character
-    if (encodingType == JSONContainerType::array) {
-        content += "[";
+    string& text = this->text();
+    if (text.length() >= sinkBufferSize || (force && text.length())) {
+        CODABLE_STAT(currentStats(), bytesWritten, text.length());
+        sink->write(text.data(), text.length());
+        text.clear();
     }
-    //If container type is closure, then add closure character
-    else if (encodingType == JSONContainerType::closure) {
-        content += "{";
+}
+
+//Writing comma before every child except the first one and key for children of closures
+void JSONEncodeContainer::writeKey(const CodingKey& key) {
+    string& text = this->text();
+    if (!isEmpty) {
+        text += ',';
     }
-    //Encode all the children
-    for (int i = 0; i < childrenIndexes.size(); i++) {
-        if (i != 0)
-            content += ",";
-        content += containers->data()[childrenIndexes[i]].content;
+    isEmpty = false;
+    //Children of closures and arrays start their own lines in pretty format, the highest value doesn't
+    if (format.style == JSONFormatStyle::pretty && depth > 0) {
+        text += '\n';
+        text.append(depth * format.indent, ' ');
     }
-    //If container type is array, then end array with specific character
-    if (encodingType == JSONContainerType::array) {
-        content += "]";
+    if (key.length) {
+        text += '\"';
+        jsonEscape(key.data, key.length, text);
+        text += format.style == JSONFormatStyle::compact ? "\":" : "\": ";
     }
-    //If container is closure, then end closure with specific character.
-    else if (encodingType == JSONContainerType::closure) {
-        content += "}";
+}
+
+void JSONEncodeContainer::writeClosingLine(const JSONEncodeContainer& child) {
+    if (format.style == JSONFormatStyle::pretty && !child.isEmpty) {
+        string& text = this->text();
+        text += '\n';
+        text.append(depth * format.indent, ' ');
     }
 }
 
 //Encoding method implementation for boolean
 void JSONEncodeContainer::encode(bool value, CodingKey key) {
-    JSONEncodeContainer result(key, "", containers);
-    result.value = value ? "true" : "false";
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
+    writeKey(key);
+    text() += value ? "true" : "false";
+}
+
+// !!! Numbers are written directly to output without temporary strings and regardless of global locale
+
+void JSONEncodeContainer::writeInteger(long long value) {
+    CODABLE_STAT(currentStats(), numbersWritten, 1);
+    char buffer[JSONNumberBufferSize];
+    text().append(buffer, jsonWriteInteger(value, buffer));
 }
 
-// !!! Encoding methods below are very similar, because they just using stringstream to convert value of specific data type to string
+void JSONEncodeContainer::writeInteger(unsigned long long value) {
+    CODABLE_STAT(currentStats(), numbersWritten, 1);
+    char buffer[JSONNumberBufferSize];
+    text().append(buffer, jsonWriteUnsigned(value, buffer));
+}
 
 //Encoding method implementation for integer
 void JSONEncodeContainer::encode(int value, CodingKey key) {
-    JSONEncodeContainer result(key, "", containers);
-    stringstream ss;
-    ss << value;
-    ss >> result.value;
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
+    writeKey(key);
+    writeInteger((long long)value);
 }
 
 //Encoding method implementation for big integer
 void JSONEncodeContainer::encode(long long value, CodingKey key) {
-    JSONEncodeContainer result(key, "", containers);
-    stringstream ss;
-    ss << value;
-    ss >> result.value;
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
+    writeKey(key);
+    writeInteger(value);
+}
+
+//Encoding method implementation for big unsigned integer
+void JSONEncodeContainer::encode(unsigned long long value, CodingKey key) {
+    writeKey(key);
+    writeInteger(value);
 }
 
-//Encoding method implementation for float
+//Encoding method implementation for float (round-trip text, usually the shortest one)
 void JSONEncodeContainer::encode(float value, CodingKey key) {
-    JSONEncodeContainer result(key, "", containers);
-    stringstream ss;
-    ss << value;
-    ss >> result.value;
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
+    writeKey(key);
+    CODABLE_STAT(currentStats(), numbersWritten, 1);
+    char buffer[JSONNumberBufferSize];
+    text().append(buffer, jsonWriteFloat(value, buffer));
 }
 
-//Encoding method implementation for accurate float
+//Encoding method implementation for accurate float (round-trip text, usually the shortest one)
 void JSONEncodeContainer::encode(double value, CodingKey key) {
-    JSONEncodeContainer result(key, "", containers);
-    stringstream ss;
-    ss << value;
-    ss >> result.value;
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
+    writeKey(key);
+    CODABLE_STAT(currentStats(), numbersWritten, 1);
+    char buffer[JSONNumberBufferSize];
+    text().append(buffer, jsonWriteDouble(value, buffer));
 }
 
 //Encoding method implementation for string
-void JSONEncodeContainer::encode(string value, CodingKey key, bool withQuotes) {
-    JSONEncodeContainer result(key, "", containers);
-    result.value = withQuotes ? ("\"" + value + "\"") : value;
-    result.encodingType = JSONContainerType::variable;
-    result.generateContent();
-    containers->push_back(result);
-    childrenIndexes.push_back(containers->size() - 1);
-}
-
-//Method that debeautifies JSON content (removes spaces and line breaks)
-void jsonDebeautify(string& content) {
-    //Creating value to prevent deleting spaces or line breaks inside field key or text value
-    bool isInValue = false;
-    for(int i=0;i<content.length();i++) {
-        if (content[i] == '\"') {
-            isInValue = !isInValue;
-        }
-        //Deleting spaces and line breaks
-        if ((content[i] == ' ' || content[i] == '\n') && !isInValue) {
-            content.erase(content.begin() + i--);
-        }
-    }
+void JSONEncodeContainer::encode(const string& value, CodingKey key, bool withQuotes) {
+    encode(value.data(), value.length(), key, withQuotes);
 }
 
-//Splitting JSON content with a lot of parameters
-//Arguments:
-// content - JSON content we want to split
-// splitter - character that splits content
-// onlyGlobal - if true, only global content (with level 0, when all previously opened brackets are closed) will be checked for matching with splitter
-// onlyNonValue - only content outside of keys and values will be checked for matching with splitter (as in jsonDebeautify method)
-vector<string> split(string content, char splitter, bool onlyGlobal = false, bool onlyNonValue = false) {
-    vector<string> result;
-    int firstIndex = 0, level = 0;
-    bool isInValue = false;
-    
-    for(int i=0;i<content.length();i++) {
-        //Updating current level by processing open and close brackets
-        if(content[i] == '{' || content[i] == '[') {
-            level++;
-        }
-        if(content[i] == '}' || content[i] == ']') {
-            level--;
-        }
-        if(content[i] == '\"') {
-            isInValue = !isInValue;
-        }
-        //Checking if character must be checked for matching with splitter
-        if((!level || !onlyGlobal) && (!isInValue || !onlyNonValue)) {
-            if(content[i] == splitter) {
-                if(i-firstIndex) {
-                    result.push_back(content.substr(firstIndex, i-firstIndex));
-                }
-                //Updating first index of new splitting part
-                firstIndex = i+1;
-            }
-        }
-    }
-    //Adding last part of splitting
-    if(content.length()-firstIndex) {
-        result.push_back(content.substr(firstIndex, content.length()-firstIndex));
+void JSONEncodeContainer::encode(const char* value, CodingKey key, bool withQuotes) {
+    encode(value, strlen(value), key, withQuotes);
+}
+
+//Strings with quotes are escaped, text without quotes is written as it is (it must be valid JSON itself)
+void JSONEncodeContainer::encode(const char* value, unsigned long length, CodingKey key, bool withQuotes) {
+    writeKey(key);
+    string& text = this->text();
+    if (withQuotes) {
+        text += '\"';
+        jsonEscape(value, length, text);
+        text += '\"';
+    } else {
+        text.append(value, length);
     }
-    return result;
 }
 
-//Constructor for JSON container for decoding
-JSONDecodeContainer::JSONDecodeContainer(string key, string content, vector<JSONDecodeContainer>* containers) {
+JSONDecodeContainer::JSONDecodeContainer(Arena* arena) {
     this->type = CoderType::json;
-    this->key = key;
-    this->containers = containers;
-    jsonDebeautify(content);
-    //Only variable container can have content with length less than 2
-    if (content.length() < 2) {
-        this->parsedType = JSONContainerType::variable;
-        this->content = content;
-        return;
+    this->arena = arena;
+    this->parsedType = JSONContainerType::variable;
+    this->keyEscaped = false;
+    this->source = NULL;
+    this->keySpan.offset = this->keySpan.length = 0;
+    this->contentSpan.offset = this->contentSpan.length = 0;
+    this->children = NULL;
+    this->childrenCount = 0;
+    this->lookupCursor = 0;
+    this->keyIndex = NULL;
+    this->keyIndexSize = 0;
+    this->expander = NULL;
+#ifdef CODABLE_ENABLE_STATS
+    this->stats = NULL;
+#endif
+}
+
+void JSONDecodeContainer::expandChildren() {
+    expander->expand(this);
+}
+
+string JSONDecodeContainer::keyString() const {
+    return string(source + keySpan.offset, keySpan.length);
+}
+
+string JSONDecodeContainer::contentString() const {
+    return string(source + contentSpan.offset, contentSpan.length);
+}
+
+void JSONDecodeContainer::keyTo(string& key) const {
+    key.clear();
+    jsonUnescape(source + keySpan.offset, keySpan.length, key);
+}
+
+bool JSONDecodeContainer::isNull() const {
+    return parsedType == JSONContainerType::variable && contentSpan.length == 4 && memcmp(source + contentSpan.offset, "null", 4) == 0;
+}
+
+bool JSONDecodeContainer::hasKey(CodingKey key) const {
+    if (!keyEscaped) {
+        return key.length == keySpan.length && memcmp(key.data, source + keySpan.offset, key.length) == 0;
     }
-    else {
-        //Every closure must begin with open brace
-        if (content[0] == '{') {
-            this->parsedType = JSONContainerType::closure;
-            //Removing braces from content
-            content.erase(content.begin());
-            content.erase(content.end() - 1);
-        }
-        //Every array must begin with open square bracket
-        else if (content[0] == '[') {
-            this->parsedType = JSONContainerType::array;
-            //Removing braces from content
-            content.erase(content.begin());
-            content.erase(content.end() - 1);
-        }
-        else {
-            this->parsedType = JSONContainerType::variable;
+    string name;
+    keyTo(name);
+    return key == CodingKey(name);
+}
+
+//Closures with more children than this count get hash table for keys lookup
+const unsigned long keyIndexThreshold = 16;
+
+//Getting container with specific key from children containers
+JSONDecodeContainer* JSONDecodeContainer::operator [](CodingKey key) {
+    expand();
+    unsigned long count = childrenCount;
+    CODABLE_STAT(stats, keyLookups, 1);
+
+    //Fast path: the next child after the last found one
+    CODABLE_STAT(stats, keyProbes, lookupCursor < count);
+    if (lookupCursor < count && children[lookupCursor]->hasKey(key)) {
+        return children[lookupCursor++];
+    }
+
+    if (count <= keyIndexThreshold) {
+        for (unsigned long i = 0; i < count; i++) {
+            CODABLE_STAT(stats, keyProbes, 1);
+            if (children[i]->hasKey(key)) {
+                lookupCursor = i + 1;
+                return children[i];
+            }
         }
-        this->content = content;
-        //Variable container is final and it can't be divided into several other containers
-        if (this->parsedType == JSONContainerType::variable) {
-            return;
+        return NULL;
+    }
+
+    //Building hash table with open addressing, its size is power of two at least twice bigger than children count
+    if (keyIndexSize == 0) {
+        unsigned long size = 1;
+        while (size < count * 2) {
+            size <<= 1;
         }
-        //Splitting content by matching with comma
-        auto splitted = split(content, ',', true, true);
-        //Process every element of splitting result
-        for (int i = 0; i < splitted.size(); i++) {
-            //Splitting key from value
-            auto keyval = split(splitted[i], ':', true, true);
-            string key = "";
-            string content = "";
-            if (keyval.size() > 1 && keyval[0].size() > 1) { //Key found
-                //Removing quotes from key
-                keyval[0].erase(keyval[0].begin());
-                keyval[0].erase(keyval[0].end() - 1);
-                key = keyval[0];
-                content = keyval[1];
+        //Elements of one document can be decoded by several threads (see JSONParallelDecoder), and building of key
+        //index is the only thing that allocates memory in arena of decoder during decoding
+        keyIndex = arena->allocateShared<unsigned>(size);
+        CODABLE_STAT(stats, allocations, 1);
+        memset(keyIndex, 0, size * sizeof(unsigned));
+        keyIndexSize = size;
+        for (unsigned long i = 0; i < count; i++) {
+            const JSONDecodeContainer* child = children[i];
+            unsigned long slot;
+            //Keys are hashed in unescaped form, like keys of lookups
+            if (child->keyEscaped) {
+                string name;
+                child->keyTo(name);
+                slot = jsonKeyHash(name.data(), name.length()) & (size - 1);
+            } else {
+                slot = jsonKeyHash(child->source + child->keySpan.offset, child->keySpan.length) & (size - 1);
             }
-            else { //There is no key for value in JSON
-                content = keyval[0];
+            while (keyIndex[slot]) {
+                slot = (slot + 1) & (size - 1);
             }
-            //Creating new container from key and value, then adding it to containers array
-            containers->push_back(JSONDecodeContainer(key, content, containers));
-            //Adding new container to children array of current container
-            childrenIndexes.push_back(containers->size()-1);
+            keyIndex[slot] = i + 1;
         }
     }
-}
-
-JSONDecodeContainer::JSONDecodeContainer(string content, vector<JSONDecodeContainer>* containers) : JSONDecodeContainer::JSONDecodeContainer(MAIN_CONTAINER_KEY, content, containers) {}
 
-//Getting container with specific key from children containers
-JSONDecodeContainer* JSONDecodeContainer::operator [](string key) {
-    for (int i = 0; i < childrenIndexes.size(); i++) {
-        if (containers->data()[childrenIndexes[i]].key == key) {
-            return &containers->data()[childrenIndexes[i]];
+    unsigned long mask = keyIndexSize - 1;
+    for (unsigned long slot = jsonKeyHash(key.data, key.length) & mask; keyIndex[slot]; slot = (slot + 1) & mask) {
+        unsigned long position = keyIndex[slot] - 1;
+        CODABLE_STAT(stats, keyProbes, 1);
+        if (children[position]->hasKey(key)) {
+            lookupCursor = position + 1;
+            return children[position];
         }
     }
     return NULL;
 }
 
 //Decoding method for boolean
-bool JSONDecodeContainer::decode(bool type, CodingKey key) {
-    JSONDecodeContainer* child = operator[](key);
-    if(child == NULL) {
-        return type;
+bool JSONDecodeContainer::decodeTo(bool& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    if (child == NULL) {
+        return false;
     }
-    string value = child->content;
-    return value == "true";
+    value = child->contentSpan.length == 4 && memcmp(child->source + child->contentSpan.offset, "true", 4) == 0;
+    return true;
 }
 
-// !!! Decoding methods below are very similar, cause they just using stringstream to produce value in specific data type from string !!!
+// !!! Numbers are parsed directly from source buffer regardless of global locale
+// !!! If value can't be parsed (or doesn't fit), then value is not changed
 
 //Decoding method for integer
-int JSONDecodeContainer::decode(int type, CodingKey key) {
-    JSONDecodeContainer* child = operator[](key);
-    if(child == NULL) {
-        return type;
+bool JSONDecodeContainer::decodeTo(int& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    CODABLE_STAT(stats, numbersParsed, child != NULL);
+    long long result;
+    if (child == NULL || !jsonParseInteger(child->source + child->contentSpan.offset, child->contentSpan.length, result)
+        || result < numeric_limits<int>::min() || result > numeric_limits<int>::max()) {
+        return false;
     }
-    string value = child->content;
-    stringstream ss;
-    ss << value;
-    int result;
-    ss >> result;
-    return result;
+    value = (int)result;
+    return true;
 }
 
 //Decoding method for big integer
-long long JSONDecodeContainer::decode(long long type, CodingKey key) {
-    JSONDecodeContainer* child = operator[](key);
-    if (child == NULL) {
-        return type;
-    }
-    string value = child->content;
-    stringstream ss;
-    ss << value;
-    long long result;
-    ss >> result;
-    return result;
+bool JSONDecodeContainer::decodeTo(long long& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    CODABLE_STAT(stats, numbersParsed, child != NULL);
+    return child != NULL && jsonParseInteger(child->source + child->contentSpan.offset, child->contentSpan.length, value);
+}
+
+//Decoding method for big unsigned integer
+bool JSONDecodeContainer::decodeTo(unsigned long long& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    CODABLE_STAT(stats, numbersParsed, child != NULL);
+    return child != NULL && jsonParseUnsigned(child->source + child->contentSpan.offset, child->contentSpan.length, value);
 }
 
 //Decoding method for float
-float JSONDecodeContainer::decode(float type, CodingKey key) {
-    JSONDecodeContainer* child = operator[](key);
-    if(child == NULL) {
-        return type;
-    }
-    string value = child->content;
-    stringstream ss;
-    ss << value;
-    float result;
-    ss >> result;
-    return result;
+bool JSONDecodeContainer::decodeTo(float& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    CODABLE_STAT(stats, numbersParsed, child != NULL);
+    return child != NULL && jsonParseFloat(child->source + child->contentSpan.offset, child->contentSpan.length, value);
 }
 
 //Decoding method for accurate float
-double JSONDecodeContainer::decode(double type, CodingKey key) {
-    JSONDecodeContainer* child = operator[](key);
+bool JSONDecodeContainer::decodeTo(double& value, CodingKey key) {
+    JSONDecodeContainer* child = target(key);
+    CODABLE_STAT(stats, numbersParsed, child != NULL);
+    return child != NULL && jsonParseDouble(child->source + child->contentSpan.offset, child->contentSpan.length, value);
+}
+
+//Decoding method for string
+bool JSONDecodeContainer::decodeTo(string& value, CodingKey key, bool withQuotes) {
+    JSONDecodeContainer* child = target(key);
     if (child == NULL) {
-        return type;
+        return false;
     }
-    string value = child->content;
-    stringstream ss;
-    ss << value;
-    double result;
-    ss >> result;
-    return result;
+    const char* text = child->source + child->contentSpan.offset;
+    unsigned long length = child->contentSpan.length;
+    //If app expects to receive this JSON field with quotes, then we have to skip them and unescape the string
+    if (length > 1 && withQuotes) {
+        value.clear();
+        jsonUnescape(text + 1, length - 2, value);
+    } else {
+        value.assign(text, length);
+    }
+    return true;
+}
+
+bool JSONDecodeContainer::decode(bool type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+int JSONDecodeContainer::decode(int type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+long long JSONDecodeContainer::decode(long long type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+float JSONDecodeContainer::decode(float type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
+}
+
+double JSONDecodeContainer::decode(double type, CodingKey key) {
+    decodeTo(type, key);
+    return type;
 }
 
-//Decoding method for string
 string JSONDecodeContainer::decode(string type, CodingKey key, bool withQuotes) {
-    JSONDecodeContainer* child = operator[](key);
-    if(child == NULL) {
-        return type;
+    decodeTo(type, key, withQuotes);
+    return type;
+}
+
+JSONEncoder::JSONEncoder(const JSONFormat& format) {
+    this->type = CoderType::json;
+    this->format = format;
+}
+
+JSONEncodeContainer JSONEncoder::container() {
+    return JSONEncodeContainer(NULL, format);
+}
+
+JSONEncodeContainer JSONEncoder::container(CoderSink* sink) {
+    return JSONEncodeContainer(sink, format);
+}
+
+void JSONEncoder::setFormat(const JSONFormat& format) {
+    this->format = format;
+}
+
+JSONDecoder::JSONDecoder() {
+    this->arena = &ownArena;
+    this->parser = new JSONParser(arena);
+    this->parser->setStats(&statistics);
+    this->usedBuffers = 0;
+}
+
+JSONDecoder::JSONDecoder(Arena* arena) {
+    this->arena = arena;
+    this->parser = new JSONParser(arena);
+    this->parser->setStats(&statistics);
+    this->usedBuffers = 0;
+}
+
+JSONDecoder::~JSONDecoder() {
+    for (CodableMappedFile* file : files) {
+        delete file;
     }
-    string value = child->content;
-    //If app expects to receive this JSON field with quotes, then we have to delete them before returning a value.
-    if (value.length() > 1 && withQuotes) {
-        value.erase(value.begin());
-        value.erase(value.begin() + value.length() - 1);
+    delete parser;
+}
+
+string& JSONDecoder::nextBuffer() {
+    //Deque doesn't move its elements, so containers of previous documents keep referring to valid texts
+    if (usedBuffers == buffers.size()) {
+        buffers.push_back(string());
     }
-    return value;
+    return buffers[usedBuffers++];
 }
 
-JSONEncodeContainer JSONEncoder::container() {
-    return JSONEncodeContainer(&containers);
+JSONDecodeContainer JSONDecoder::parseBuffer() {
+    const string& buffer = buffers[usedBuffers - 1];
+    return *parser->parse(buffer.data(), buffer.length());
+}
+
+JSONDecodeContainer JSONDecoder::container(const string& content) {
+    nextBuffer().assign(content);
+    return parseBuffer();
+}
+
+JSONDecodeContainer JSONDecoder::container(const char* content, unsigned long length) {
+    nextBuffer().assign(content, length);
+    return parseBuffer();
+}
+
+JSONDecodeContainer JSONDecoder::container(string&& content) {
+    nextBuffer().swap(content);
+    content.clear();
+    return parseBuffer();
+}
+
+JSONDecodeContainer JSONDecoder::containerFromFile(const string& path) {
+    CodableMappedFile* file = new CodableMappedFile();
+    files.push_back(file);
+    file->open(path.c_str());
+    return *parser->parse(file->data, file->length);
+}
+
+void JSONDecoder::setMaxDepth(unsigned long depth) {
+    parser->setMaxDepth(depth);
+}
+
+void JSONDecoder::setLazy(bool lazy) {
+    parser->setLazy(lazy);
 }
 
-JSONDecodeContainer JSONDecoder::container(string content) {
-    return JSONDecodeContainer(content, &containers);
+void JSONDecoder::reset() {
+    //Containers own no resources, so their memory is just marked as free, texts are kept as buffers for the next documents
+    arena->reset();
+    usedBuffers = 0;
+    for (CodableMappedFile* file : files) {
+        delete file;
+    }
+    files.clear();
 }
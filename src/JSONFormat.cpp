@@ -0,0 +1,112 @@
+#include "JSONFormat.hpp"
+#include <vector>
+
+using namespace std;
+
+//Checking if character is JSON whitespace
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+//Checking if character ends value that isn't string (number, boolean or null)
+static inline bool isDelimiter(char c) {
+    return isWhitespace(c) || c == ',' || c == ':' || c == '{' || c == '}' || c == '[' || c == ']' || c == '\"';
+}
+
+//Starting new line with indent of specific level of nesting
+static inline void writeLine(string& output, const JSONFormat& format, unsigned long level) {
+    output += '\n';
+    output.append(level * format.indent, ' ');
+}
+
+bool jsonReformat(const char* text, unsigned long length, const JSONFormat& format, string& output) {
+    bool pretty = format.style == JSONFormatStyle::pretty;
+    bool valid = true;
+    //True right after opening bracket, so empty closures and arrays are written without lines
+    bool opened = false;
+    //Opening brackets of closures and arrays that aren't finished
+    vector<char> brackets;
+    unsigned long position = 0;
+    while (position < length) {
+        char c = text[position];
+        switch (c) {
+        case ' ':
+        case '\n':
+        case '\r':
+        case '\t':
+            position++;
+            break;
+        case '\"': {
+            //String is copied with its escapes, escaped quotes don't finish it
+            unsigned long end = position + 1;
+            while (end < length && text[end] != '\"') {
+                end += text[end] == '\\' ? 2 : 1;
+            }
+            if (end >= length) {
+                output.append(text + position, length - position);
+                return false;
+            }
+            output.append(text + position, end + 1 - position);
+            position = end + 1;
+            opened = false;
+            break;
+        }
+        case '{':
+        case '[': {
+            brackets.push_back(c);
+            output += c;
+            position++;
+            opened = true;
+            while (position < length && isWhitespace(text[position])) {
+                position++;
+            }
+            if (pretty && position < length && text[position] != '}' && text[position] != ']') {
+                writeLine(output, format, brackets.size());
+            }
+            break;
+        }
+        case '}':
+        case ']': {
+            if (brackets.empty() || brackets.back() != (c == '}' ? '{' : '[')) {
+                valid = false;
+            } else {
+                brackets.pop_back();
+            }
+            if (pretty && !opened) {
+                writeLine(output, format, brackets.size());
+            }
+            output += c;
+            position++;
+            opened = false;
+            break;
+        }
+        case ',':
+            output += ',';
+            opened = false;
+            if (pretty) {
+                writeLine(output, format, brackets.size());
+            }
+            position++;
+            break;
+        case ':':
+            output += format.style == JSONFormatStyle::compact ? ":" : ": ";
+            position++;
+            break;
+        default: {
+            unsigned long end = position + 1;
+            while (end < length && !isDelimiter(text[end])) {
+                end++;
+            }
+            output.append(text + position, end - position);
+            position = end;
+            opened = false;
+            break;
+        }
+        }
+    }
+    return valid && brackets.empty();
+}
+
+bool jsonMinify(const char* text, unsigned long length, string& output) {
+    return jsonReformat(text, length, JSONFormat(JSONFormatStyle::compact), output);
+}
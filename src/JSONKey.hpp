@@ -0,0 +1,16 @@
+#ifndef JSON_KEY_H
+#define JSON_KEY_H
+
+//Internal helpers for keys of closures, shared by key index of decode containers and decode plans,
+//so both of them hash keys in the same way
+
+//FNV-1a hash of key
+static inline unsigned jsonKeyHash(const char* key, unsigned long length) {
+    unsigned hash = 2166136261u;
+    for (unsigned long i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)key[i]) * 16777619u;
+    }
+    return hash;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "JSONLines.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+//Minimal count of records in chunk of work of one thread
+const unsigned long linesPerThread = 64;
+
+//Checking if character is JSON whitespace
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+JSONLinesDecoder::JSONLinesDecoder(unsigned threads) : pool(max(threads, 1u)) {
+    for (unsigned i = 0; i < pool.size(); i++) {
+        workers.push_back(new JSONRecordParser());
+    }
+}
+
+JSONLinesDecoder::~JSONLinesDecoder() {
+    for (JSONRecordParser* worker : workers) {
+        delete worker;
+    }
+}
+
+bool JSONLinesDecoder::nextLine(const char* text, unsigned long length, unsigned long& position, JSONSpan& line) {
+    while (position < length) {
+        const char* found = (const char*)memchr(text + position, '\n', length - position);
+        unsigned long begin = position, end = found != NULL ? found - text : length;
+        position = end + 1;
+        //Whitespaces around record (including \r of CRLF) are removed, empty lines are skipped
+        while (begin < end && isWhitespace(text[begin])) begin++;
+        while (end > begin && isWhitespace(text[end - 1])) end--;
+        if (begin < end) {
+            line.offset = begin;
+            line.length = end - begin;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JSONLinesDecoder::findLines(const char* text, unsigned long length) {
+    lines.clear();
+    JSONSpan line;
+    for (unsigned long position = 0; nextLine(text, length, position, line); ) {
+        lines.push_back(line);
+    }
+}
+
+void JSONLinesDecoder::run(const function<void(JSONRecordParser&, unsigned long, unsigned long)>& function) {
+    //Several chunks per thread let threads that got short records help the other ones
+    unsigned long count = lines.size();
+    unsigned long grain = max(linesPerThread, count / (pool.size() * 8));
+    pool.parallelFor(count, grain, [&](unsigned worker, unsigned long begin, unsigned long end) {
+        function(*workers[worker], begin, end);
+    });
+}
@@ -0,0 +1,916 @@
+#include "JSONNumber.hpp"
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+//Unsigned big integer, used for computing tables of powers and for exact parsing of ambiguous long numbers
+class BigInteger {
+public:
+    //Words from the lowest to the highest
+    vector<uint32_t> words;
+
+    BigInteger(uint32_t value) {
+        words.push_back(value);
+    }
+
+    void multiply(uint32_t multiplier) {
+        uint64_t carry = 0;
+        for (unsigned long i = 0; i < words.size(); i++) {
+            uint64_t product = (uint64_t)words[i] * multiplier + carry;
+            words[i] = (uint32_t)product;
+            carry = product >> 32;
+        }
+        if (carry) {
+            words.push_back((uint32_t)carry);
+        }
+    }
+
+    //Division with rounding down
+    void divide(uint32_t divisor) {
+        uint64_t remainder = 0;
+        for (unsigned long i = words.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | words[i];
+            words[i] = (uint32_t)(current / divisor);
+            remainder = current % divisor;
+        }
+        trim();
+    }
+
+    void shiftLeft(unsigned long count) {
+        words.insert(words.begin(), count / 32, 0);
+        count %= 32;
+        if (count) {
+            uint32_t carry = 0;
+            for (unsigned long i = 0; i < words.size(); i++) {
+                uint32_t word = words[i];
+                words[i] = (word << count) | carry;
+                carry = word >> (32 - count);
+            }
+            if (carry) {
+                words.push_back(carry);
+            }
+        }
+    }
+
+    //Shift with rounding down
+    void shiftRight(unsigned long count) {
+        BigInteger result(0);
+        result.words.assign(words.size(), 0);
+        for (unsigned long i = 0; i < result.words.size(); i++) {
+            result.words[i] = (uint32_t)bits(i * 32 + count);
+        }
+        result.trim();
+        words.swap(result.words);
+    }
+
+    void add(uint32_t value) {
+        uint64_t carry = value;
+        for (unsigned long i = 0; i < words.size() && carry; i++) {
+            uint64_t sum = (uint64_t)words[i] + carry;
+            words[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        if (carry) {
+            words.push_back((uint32_t)carry);
+        }
+    }
+
+    //Multiplication by 10^exponent
+    void multiplyByPowerOfTen(unsigned long exponent) {
+        for (; exponent >= 9; exponent -= 9) {
+            multiply(1000000000);
+        }
+        static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+        multiply(powers[exponent]);
+    }
+
+    //Returns negative number, zero or positive number if this number is less, equal or greater than other one
+    int compare(const BigInteger& other) const {
+        unsigned long size = significantSize(), otherSize = other.significantSize();
+        if (size != otherSize) {
+            return size < otherSize ? -1 : 1;
+        }
+        for (unsigned long i = size; i-- > 0;) {
+            if (words[i] != other.words[i]) {
+                return words[i] < other.words[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    void increment() {
+        for (unsigned long i = 0; i < words.size(); i++) {
+            if (++words[i] != 0) {
+                return;
+            }
+        }
+        words.push_back(1);
+    }
+
+    long bitLength() const {
+        long length = (long)(words.size() - 1) * 32;
+        for (uint32_t word = words.back(); word; word >>= 1) {
+            length++;
+        }
+        return length;
+    }
+
+    //Bits with positions [from, from + 64), positions out of number are zeroes
+    uint64_t bits(long from) const {
+        uint64_t result = 0;
+        for (int i = 0; i < 64; i++) {
+            long position = from + i;
+            if (position >= 0 && (unsigned long)(position / 32) < words.size() && ((words[position / 32] >> (position % 32)) & 1)) {
+                result |= (uint64_t)1 << i;
+            }
+        }
+        return result;
+    }
+
+    //The highest 64 bits rounded to nearest, exponent is set to position of the lowest of them
+    uint64_t rounded(long& exponent) const {
+        long length = bitLength();
+        exponent = length - 64;
+        uint64_t result = bits(exponent);
+        if (exponent > 0 && (bits(exponent - 1) & 1)) {
+            if (++result == 0) {
+                result = (uint64_t)1 << 63;
+                exponent++;
+            }
+        }
+        return result;
+    }
+
+private:
+    //Count of words without zero words at the top
+    unsigned long significantSize() const {
+        unsigned long size = words.size();
+        while (size > 0 && words[size - 1] == 0) {
+            size--;
+        }
+        return size;
+    }
+
+    void trim() {
+        while (words.size() > 1 && words.back() == 0) {
+            words.pop_back();
+        }
+    }
+};
+
+//Exponents of the smallest and the largest powers of five in Eisel-Lemire table
+const int smallestPowerOfFive = -342;
+const int largestPowerOfFive = 308;
+//Cached powers of ten for Grisu: 10^k for k = -300, -292, ..., 324
+const int cachedPowersMinDecimalExponent = -300;
+const int cachedPowersDecimalStep = 8;
+const int cachedPowersCount = 79;
+
+//Tables of powers computed exactly on the first use
+//Consists of:
+// fives - 5^q for q in [-342, 308] as 128-bit numbers (high word first) with the highest bit set, truncated
+// cachedSignificands, cachedExponents - 10^k as normalized 64-bit significand and binary exponent
+struct PowerTables {
+    uint64_t fives[2 * (largestPowerOfFive - smallestPowerOfFive + 1)];
+    uint64_t cachedSignificands[cachedPowersCount];
+    int cachedExponents[cachedPowersCount];
+
+    PowerTables() {
+        //Powers of five with non-negative exponents
+        BigInteger power(1);
+        vector<BigInteger> positive;
+        for (int q = 0; q <= -smallestPowerOfFive; q++) {
+            positive.push_back(power);
+            power.multiply(5);
+        }
+        for (int q = 0; q <= largestPowerOfFive; q++) {
+            long length = positive[q].bitLength();
+            fives[2 * (q - smallestPowerOfFive)] = positive[q].bits(length - 64);
+            fives[2 * (q - smallestPowerOfFive) + 1] = positive[q].bits(length - 128);
+        }
+
+        //Negative exponents: floor(2^b / 5^n) is taken from floor(2^B / 5^n) with big enough B
+        const long scale = 2 * positive.back().bitLength() + 128;
+        BigInteger quotient(1);
+        quotient.shiftLeft(scale);
+        vector<BigInteger> negative;
+        negative.push_back(quotient);
+        for (int n = 1; n <= -smallestPowerOfFive; n++) {
+            quotient.divide(5);
+            negative.push_back(quotient);
+        }
+        for (int n = 1; n <= -smallestPowerOfFive; n++) {
+            //The same approximation as in reference implementation: floor(2^b / 5^n) + 1 truncated to 128 bits
+            long z = positive[n].bitLength();
+            long b = n <= 27 ? z + 127 : 2 * z + 128;
+            BigInteger value = negative[n];
+            value.shiftRight(scale - b);
+            value.increment();
+            long length = value.bitLength();
+            fives[2 * (-n - smallestPowerOfFive)] = value.bits(length - 64);
+            fives[2 * (-n - smallestPowerOfFive) + 1] = value.bits(length - 128);
+        }
+
+        //10^k = 5^k * 2^k
+        for (int i = 0; i < cachedPowersCount; i++) {
+            int k = cachedPowersMinDecimalExponent + i * cachedPowersDecimalStep;
+            long exponent;
+            if (k >= 0) {
+                cachedSignificands[i] = positive[k].rounded(exponent);
+                cachedExponents[i] = (int)(exponent + k);
+            }
+            else {
+                cachedSignificands[i] = negative[-k].rounded(exponent);
+                cachedExponents[i] = (int)(exponent + k - scale);
+            }
+        }
+    }
+};
+
+static const PowerTables& powerTables() {
+    static const PowerTables tables;
+    return tables;
+}
+
+// !!! Writing of floating point numbers (Grisu2 by Florian Loitsch) !!!
+
+//Floating point number with 64-bit significand: f * 2^e
+struct DiyFloat {
+    uint64_t f;
+    int e;
+
+    DiyFloat(uint64_t f, int e) : f(f), e(e) {}
+};
+
+static inline DiyFloat diySubtract(const DiyFloat& x, const DiyFloat& y) {
+    return DiyFloat(x.f - y.f, x.e);
+}
+
+//Product rounded to the highest 64 bits
+static inline DiyFloat diyMultiply(const DiyFloat& x, const DiyFloat& y) {
+    uint64_t xLow = x.f & 0xFFFFFFFFu, xHigh = x.f >> 32;
+    uint64_t yLow = y.f & 0xFFFFFFFFu, yHigh = y.f >> 32;
+    uint64_t p0 = xLow * yLow, p1 = xLow * yHigh, p2 = xHigh * yLow, p3 = xHigh * yHigh;
+    uint64_t middle = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu) + ((uint64_t)1 << 31);
+    return DiyFloat(p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32), x.e + y.e + 64);
+}
+
+static inline DiyFloat diyNormalize(DiyFloat x) {
+    while ((x.f >> 63) == 0) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+static inline DiyFloat diyNormalizeTo(const DiyFloat& x, int e) {
+    return DiyFloat(x.f << (x.e - e), e);
+}
+
+//Exponents range of scaled value for digits generation
+const int grisuAlpha = -60;
+const int grisuGamma = -32;
+
+//Computing value and its boundaries (middles between value and its neighbours)
+//Precision is count of significand bits including hidden one (24 for float, 53 for double)
+static void computeBoundaries(uint64_t bits, int precision, int maxExponent, DiyFloat& w, DiyFloat& minus, DiyFloat& plus) {
+    const int bias = maxExponent - 1 + (precision - 1);
+    const uint64_t hiddenBit = (uint64_t)1 << (precision - 1);
+    const uint64_t E = bits >> (precision - 1);
+    const uint64_t F = bits & (hiddenBit - 1);
+
+    DiyFloat v = E == 0 ? DiyFloat(F, 1 - bias) : DiyFloat(F + hiddenBit, (int)E - bias);
+    //Lower boundary is closer when significand is a power of two
+    bool lowerBoundaryIsCloser = F == 0 && E > 1;
+    DiyFloat mPlus((v.f << 1) + 1, v.e - 1);
+    DiyFloat mMinus = lowerBoundaryIsCloser ? DiyFloat((v.f << 2) - 1, v.e - 2) : DiyFloat((v.f << 1) - 1, v.e - 1);
+
+    plus = diyNormalize(mPlus);
+    minus = diyNormalizeTo(mMinus, plus.e);
+    w = diyNormalize(v);
+}
+
+//Finding the largest power of ten that is not bigger than n, returns count of digits of n
+static inline int largestPowerOfTen(uint32_t n, uint32_t& power) {
+    static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+    int digits = 10;
+    while (digits > 1 && n < powers[digits - 1]) {
+        digits--;
+    }
+    power = powers[digits - 1];
+    return digits;
+}
+
+//Moving the last digit closer to the exact value while it stays inside of boundaries
+static inline void grisuRound(char* buffer, int length, uint64_t distance, uint64_t delta, uint64_t rest, uint64_t tenK) {
+    while (rest < distance && delta - rest >= tenK && (rest + tenK < distance || distance - rest > rest + tenK - distance)) {
+        buffer[length - 1]--;
+        rest += tenK;
+    }
+}
+
+//Generating the shortest digits of a number inside of [minus, plus]
+static void grisuDigits(char* buffer, int& length, int& decimalExponent, DiyFloat minus, DiyFloat w, DiyFloat plus) {
+    uint64_t delta = diySubtract(plus, minus).f;
+    uint64_t distance = diySubtract(plus, w).f;
+
+    const DiyFloat one((uint64_t)1 << -plus.e, plus.e);
+    uint32_t p1 = (uint32_t)(plus.f >> -one.e);
+    uint64_t p2 = plus.f & (one.f - 1);
+
+    uint32_t power;
+    int n = largestPowerOfTen(p1, power);
+    while (n > 0) {
+        uint32_t digit = p1 / power;
+        p1 %= power;
+        buffer[length++] = (char)('0' + digit);
+        n--;
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            decimalExponent += n;
+            grisuRound(buffer, length, distance, delta, rest, (uint64_t)power << -one.e);
+            return;
+        }
+        power /= 10;
+    }
+
+    int m = 0;
+    for (;;) {
+        p2 *= 10;
+        uint64_t digit = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buffer[length++] = (char)('0' + digit);
+        m++;
+        delta *= 10;
+        distance *= 10;
+        if (p2 <= delta) {
+            break;
+        }
+    }
+    decimalExponent -= m;
+    grisuRound(buffer, length, distance, delta, p2, one.f);
+}
+
+static void grisu(char* buffer, int& length, int& decimalExponent, uint64_t bits, int precision, int maxExponent) {
+    DiyFloat w(0, 0), minus(0, 0), plus(0, 0);
+    computeBoundaries(bits, precision, maxExponent, w, minus, plus);
+
+    //Finding cached power c = 10^k, so that alpha <= e(c * plus) <= gamma
+    const PowerTables& tables = powerTables();
+    int f = grisuAlpha - plus.e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    int index = (-cachedPowersMinDecimalExponent + k + (cachedPowersDecimalStep - 1)) / cachedPowersDecimalStep;
+    DiyFloat cached(tables.cachedSignificands[index], tables.cachedExponents[index]);
+
+    DiyFloat scaled = diyMultiply(w, cached);
+    DiyFloat scaledMinus = diyMultiply(minus, cached);
+    DiyFloat scaledPlus = diyMultiply(plus, cached);
+    //Boundaries are shrunk by one unit because of multiplication error
+    DiyFloat lower(scaledMinus.f + 1, scaledMinus.e);
+    DiyFloat upper(scaledPlus.f - 1, scaledPlus.e);
+
+    length = 0;
+    decimalExponent = -(cachedPowersMinDecimalExponent + index * cachedPowersDecimalStep);
+    grisuDigits(buffer, length, decimalExponent, lower, scaled, upper);
+}
+
+//Writing exponent with sign and at least two digits
+static int writeExponent(int exponent, char* buffer) {
+    int length = 0;
+    buffer[length++] = 'e';
+    buffer[length++] = exponent < 0 ? '-' : '+';
+    if (exponent < 0) {
+        exponent = -exponent;
+    }
+    if (exponent >= 100) {
+        buffer[length++] = (char)('0' + exponent / 100);
+        exponent %= 100;
+    }
+    buffer[length++] = (char)('0' + exponent / 10);
+    buffer[length++] = (char)('0' + exponent % 10);
+    return length;
+}
+
+//Placing decimal point into digits: buffer contains digits * 10^decimalExponent
+//Numbers with decimal point position in (-4, 15] are written without exponent
+static int formatDigits(char* buffer, int length, int decimalExponent) {
+    const int minExponent = -4;
+    const int maxExponent = 15;
+    int point = length + decimalExponent;
+
+    //digits000
+    if (length <= point && point <= maxExponent) {
+        memset(buffer + length, '0', point - length);
+        return point;
+    }
+    //dig.its
+    if (0 < point && point <= maxExponent) {
+        memmove(buffer + point + 1, buffer + point, length - point);
+        buffer[point] = '.';
+        return length + 1;
+    }
+    //0.000digits
+    if (minExponent < point && point <= 0) {
+        memmove(buffer + 2 - point, buffer, length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        memset(buffer + 2, '0', -point);
+        return 2 - point + length;
+    }
+    //d.igitse+123
+    if (length == 1) {
+        return 1 + writeExponent(point - 1, buffer + 1);
+    }
+    memmove(buffer + 2, buffer + 1, length - 1);
+    buffer[1] = '.';
+    return length + 1 + writeExponent(point - 1, buffer + length + 1);
+}
+
+static int writeFloating(uint64_t bits, bool negative, bool zero, bool finite, int precision, int maxExponent, char* buffer) {
+    if (!finite) {
+        memcpy(buffer, "null", 4);
+        return 4;
+    }
+    int length = 0;
+    if (negative) {
+        buffer[length++] = '-';
+    }
+    if (zero) {
+        buffer[length++] = '0';
+        return length;
+    }
+    int digits, decimalExponent;
+    grisu(buffer + length, digits, decimalExponent, bits, precision, maxExponent);
+    return length + formatDigits(buffer + length, digits, decimalExponent);
+}
+
+// !!! Parsing of floating point numbers (Clinger's fast path and Eisel-Lemire algorithm) !!!
+
+//Parameters of binary floating point formats
+template <typename T>
+struct BinaryFormat;
+
+template <>
+struct BinaryFormat<double> {
+    typedef uint64_t Bits;
+    static const int mantissaBits = 52;
+    static const int minimumExponent = -1023;
+    static const int infinitePower = 0x7FF;
+    static const int smallestPowerOfTen = -342;
+    static const int largestPowerOfTen = 308;
+    static const int minRoundToEven = -4;
+    static const int maxRoundToEven = 23;
+    static const int maxExactPowerOfTen = 22;
+};
+
+template <>
+struct BinaryFormat<float> {
+    typedef uint32_t Bits;
+    static const int mantissaBits = 23;
+    static const int minimumExponent = -127;
+    static const int infinitePower = 0xFF;
+    static const int smallestPowerOfTen = -65;
+    static const int largestPowerOfTen = 38;
+    static const int minRoundToEven = -17;
+    static const int maxRoundToEven = 10;
+    static const int maxExactPowerOfTen = 10;
+};
+
+//Decimal number from text: mantissa * 10^exponent
+//Consists of:
+// negative - sign of number
+// mantissa - the first 19 significant digits
+// exponent - decimal exponent of mantissa
+// truncated - true if some non-zero digits didn't fit into mantissa
+// integer - true if text has neither fraction nor exponent
+struct DecimalNumber {
+    bool negative;
+    uint64_t mantissa;
+    long long exponent;
+    bool truncated;
+    bool integer;
+};
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool scanDecimal(const char* text, unsigned long length, DecimalNumber& number) {
+    const char* end = text + length;
+    number.negative = false;
+    number.mantissa = 0;
+    number.exponent = 0;
+    number.truncated = false;
+    number.integer = true;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        number.negative = *text == '-';
+        text++;
+    }
+
+    int significant = 0;
+    bool hasDigits = false;
+    //Integer part
+    for (; text < end && isDigit(*text); text++) {
+        hasDigits = true;
+        if (significant == 0 && *text == '0') {
+            continue;
+        }
+        if (significant < 19) {
+            number.mantissa = number.mantissa * 10 + (*text - '0');
+            significant++;
+        }
+        else {
+            number.exponent++;
+            number.truncated |= *text != '0';
+        }
+    }
+    //Fraction
+    if (text < end && *text == '.') {
+        number.integer = false;
+        for (text++; text < end && isDigit(*text); text++) {
+            hasDigits = true;
+            if (significant == 0 && *text == '0') {
+                number.exponent--;
+                continue;
+            }
+            if (significant < 19) {
+                number.mantissa = number.mantissa * 10 + (*text - '0');
+                number.exponent--;
+                significant++;
+            }
+            else {
+                number.truncated |= *text != '0';
+            }
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+    //Exponent
+    if (text < end && (*text == 'e' || *text == 'E')) {
+        number.integer = false;
+        text++;
+        bool negativeExponent = false;
+        if (text < end && (*text == '-' || *text == '+')) {
+            negativeExponent = *text == '-';
+            text++;
+        }
+        if (text == end || !isDigit(*text)) {
+            return false;
+        }
+        long long exponent = 0;
+        for (; text < end && isDigit(*text); text++) {
+            //Exponents that big give zero or infinity anyway
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (*text - '0');
+            }
+        }
+        number.exponent += negativeExponent ? -exponent : exponent;
+    }
+    return text == end;
+}
+
+struct Value128 {
+    uint64_t low;
+    uint64_t high;
+};
+
+static inline Value128 multiply128(uint64_t a, uint64_t b) {
+    Value128 result;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    result.low = (uint64_t)product;
+    result.high = (uint64_t)(product >> 64);
+#else
+    uint64_t aLow = a & 0xFFFFFFFFu, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFFu, bHigh = b >> 32;
+    uint64_t ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+    uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    result.low = (middle << 32) | (ll & 0xFFFFFFFFu);
+    result.high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+    return result;
+}
+
+static inline int leadingZeroes(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    while (!(value & ((uint64_t)1 << 63))) {
+        value <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+//Binary significand (without hidden bit) and biased exponent of w * 10^q
+template <typename T>
+static void eiselLemire(long long q, uint64_t w, uint64_t& mantissa, int& power2) {
+    typedef BinaryFormat<T> Format;
+    if (w == 0 || q < Format::smallestPowerOfTen) {
+        mantissa = 0;
+        power2 = 0;
+        return;
+    }
+    if (q > Format::largestPowerOfTen) {
+        mantissa = 0;
+        power2 = Format::infinitePower;
+        return;
+    }
+
+    int lz = leadingZeroes(w);
+    w <<= lz;
+
+    //Product of w and 5^q with enough precision for rounding
+    const uint64_t* five = powerTables().fives + 2 * (q - smallestPowerOfFive);
+    const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFull >> (Format::mantissaBits + 3);
+    Value128 product = multiply128(w, five[0]);
+    if ((product.high & precisionMask) == precisionMask) {
+        Value128 second = multiply128(w, five[1]);
+        product.low += second.high;
+        if (second.high > product.low) {
+            product.high++;
+        }
+    }
+
+    int upperBit = (int)(product.high >> 63);
+    int shift = upperBit + 64 - Format::mantissaBits - 3;
+    mantissa = product.high >> shift;
+    power2 = (int)((((152170 + 65536) * q) >> 16) + 63) + upperBit - lz - Format::minimumExponent;
+
+    //Subnormal numbers
+    if (power2 <= 0) {
+        if (-power2 + 1 >= 64) {
+            mantissa = 0;
+            power2 = 0;
+            return;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < ((uint64_t)1 << Format::mantissaBits) ? 0 : 1;
+        return;
+    }
+
+    //Exact middle between two numbers is rounded to even
+    if (product.low <= 1 && q >= Format::minRoundToEven && q <= Format::maxRoundToEven && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == product.high) {
+            mantissa &= ~(uint64_t)1;
+        }
+    }
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= ((uint64_t)2 << Format::mantissaBits)) {
+        mantissa = (uint64_t)1 << Format::mantissaBits;
+        power2++;
+    }
+    mantissa &= ~((uint64_t)1 << Format::mantissaBits);
+    if (power2 >= Format::infinitePower) {
+        power2 = Format::infinitePower;
+        mantissa = 0;
+    }
+}
+
+template <typename T>
+static T fromBits(uint64_t mantissa, int power2, bool negative) {
+    typedef BinaryFormat<T> Format;
+    typename Format::Bits bits = (typename Format::Bits)(mantissa | ((uint64_t)power2 << Format::mantissaBits));
+    if (negative) {
+        bits |= (typename Format::Bits)1 << (sizeof(T) * 8 - 1);
+    }
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+//Slow but exact rounding of numbers whose digits don't fit into mantissa of decimal number
+//Decimal value of text is compared using big integers with the middle between floating point number that is given
+//by mantissa and power2 and the next one, so the result is correctly rounded for any count of digits
+template <typename T>
+static void roundExactly(const char* text, unsigned long length, uint64_t& mantissa, int& power2) {
+    typedef BinaryFormat<T> Format;
+    //All digits of text as one integer (by pieces of 9 digits) and decimal exponent of its last digit
+    BigInteger digits(0);
+    long long exponent = 0;
+    uint32_t piece = 0, pieceScale = 1;
+    const char* end = text + length;
+    bool fraction = false;
+    for (; text < end && *text != 'e' && *text != 'E'; text++) {
+        if (*text == '.') {
+            fraction = true;
+        } else if (isDigit(*text)) {
+            piece = piece * 10 + (*text - '0');
+            pieceScale *= 10;
+            exponent -= fraction;
+            if (pieceScale == 1000000000) {
+                digits.multiply(pieceScale);
+                digits.add(piece);
+                piece = 0;
+                pieceScale = 1;
+            }
+        }
+    }
+    digits.multiply(pieceScale);
+    digits.add(piece);
+    if (text < end) {
+        text++;
+        bool negativeExponent = *text == '-';
+        if (*text == '-' || *text == '+') {
+            text++;
+        }
+        long long explicitExponent = 0;
+        for (; text < end; text++) {
+            if (explicitExponent < 100000) {
+                explicitExponent = explicitExponent * 10 + (*text - '0');
+            }
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    //Middle between two numbers: (2 * significand + 1) * 2^binaryExponent
+    if (power2 > 0) {
+        mantissa &= ~((uint64_t)1 << Format::mantissaBits);
+    }
+    uint64_t significand = power2 > 0 ? mantissa | ((uint64_t)1 << Format::mantissaBits) : mantissa;
+    long binaryExponent = (power2 > 0 ? power2 : 1) + Format::minimumExponent - Format::mantissaBits - 1;
+    uint64_t doubled = 2 * significand + 1;
+    BigInteger middle((uint32_t)(doubled >> 32));
+    middle.shiftLeft(32);
+    middle.add((uint32_t)doubled);
+
+    //Both numbers are made integers with the same scale
+    if (exponent >= 0) {
+        digits.multiplyByPowerOfTen((unsigned long)exponent);
+    } else {
+        middle.multiplyByPowerOfTen((unsigned long)-exponent);
+    }
+    if (binaryExponent >= 0) {
+        middle.shiftLeft(binaryExponent);
+    } else {
+        digits.shiftLeft(-binaryExponent);
+    }
+
+    //Exact middle is rounded to even, carry of mantissa goes to exponent (up to infinity)
+    int order = digits.compare(middle);
+    if (order > 0 || (order == 0 && (mantissa & 1))) {
+        mantissa++;
+        if (mantissa >> Format::mantissaBits) {
+            mantissa = 0;
+            power2++;
+        }
+    }
+}
+
+template <typename T>
+static bool parseFloating(const char* text, unsigned long length, T& value) {
+    typedef BinaryFormat<T> Format;
+    DecimalNumber number;
+    if (!scanDecimal(text, length, number)) {
+        return false;
+    }
+
+    if (number.mantissa == 0) {
+        value = number.negative ? -T(0) : T(0);
+        return true;
+    }
+
+    //Clinger's fast path: both mantissa and power of ten are exact, so one rounding gives correct result
+    static const double exactPowers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    if (!number.truncated && number.exponent >= -Format::maxExactPowerOfTen && number.exponent <= Format::maxExactPowerOfTen
+        && number.mantissa <= ((uint64_t)1 << (Format::mantissaBits + 1))) {
+        T result = (T)number.mantissa;
+        result = number.exponent < 0 ? result / (T)exactPowers[-number.exponent] : result * (T)exactPowers[number.exponent];
+        value = number.negative ? -result : result;
+        return true;
+    }
+
+    uint64_t mantissa;
+    int power2;
+    eiselLemire<T>(number.exponent, number.mantissa, mantissa, power2);
+    if (number.truncated) {
+        //Truncated digits are somewhere between mantissa and mantissa + 1, result is exact if both give the same number
+        uint64_t upperMantissa;
+        int upperPower2;
+        eiselLemire<T>(number.exponent, number.mantissa + 1, upperMantissa, upperPower2);
+        if (upperMantissa != mantissa || upperPower2 != power2) {
+            roundExactly<T>(text, length, mantissa, power2);
+        }
+    }
+    value = fromBits<T>(mantissa, power2, number.negative);
+    return true;
+}
+
+// !!! Public functions !!!
+
+//Pairs of digits for writing two digits at once
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+int jsonWriteUnsigned(unsigned long long value, char* buffer) {
+    char digits[24];
+    char* position = digits + sizeof(digits);
+    while (value >= 100) {
+        const char* pair = digitPairs + (value % 100) * 2;
+        value /= 100;
+        *--position = pair[1];
+        *--position = pair[0];
+    }
+    if (value >= 10) {
+        const char* pair = digitPairs + value * 2;
+        *--position = pair[1];
+        *--position = pair[0];
+    }
+    else {
+        *--position = (char)('0' + value);
+    }
+    int length = (int)(digits + sizeof(digits) - position);
+    memcpy(buffer, position, length);
+    return length;
+}
+
+int jsonWriteInteger(long long value, char* buffer) {
+    if (value < 0) {
+        buffer[0] = '-';
+        return 1 + jsonWriteUnsigned(0ull - (unsigned long long)value, buffer + 1);
+    }
+    return jsonWriteUnsigned((unsigned long long)value, buffer);
+}
+
+int jsonWriteDouble(double value, char* buffer) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 63) != 0;
+    bits &= ~((uint64_t)1 << 63);
+    bool finite = (bits >> 52) != 0x7FF;
+    return writeFloating(bits, negative, bits == 0, finite, numeric_limits<double>::digits, numeric_limits<double>::max_exponent, buffer);
+}
+
+int jsonWriteFloat(float value, char* buffer) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 31) != 0;
+    bits &= ~((uint32_t)1 << 31);
+    bool finite = (bits >> 23) != 0xFF;
+    return writeFloating(bits, negative, bits == 0, finite, numeric_limits<float>::digits, numeric_limits<float>::max_exponent, buffer);
+}
+
+bool jsonParseUnsigned(const char* text, unsigned long length, unsigned long long& value) {
+    //Fast path for plain digits
+    unsigned long long result = 0;
+    unsigned long i = 0;
+    for (; i < length && isDigit(text[i]); i++) {
+        unsigned digit = text[i] - '0';
+        if (result > (numeric_limits<unsigned long long>::max() - digit) / 10) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    if (i == length && length) {
+        value = result;
+        return true;
+    }
+    //Numbers with fraction or exponent are truncated
+    double floating;
+    if (!jsonParseDouble(text, length, floating) || !(floating > -1.0 && floating < 18446744073709551616.0)) {
+        return false;
+    }
+    value = floating <= 0 ? 0 : (unsigned long long)floating;
+    return true;
+}
+
+bool jsonParseInteger(const char* text, unsigned long length, long long& value) {
+    bool negative = length && text[0] == '-';
+    unsigned long long magnitude;
+    if (!jsonParseUnsigned(text + negative, length - negative, magnitude)) {
+        return false;
+    }
+    if (negative ? magnitude > (unsigned long long)numeric_limits<long long>::max() + 1 : magnitude > (unsigned long long)numeric_limits<long long>::max()) {
+        return false;
+    }
+    value = negative ? (long long)(0ull - magnitude) : (long long)magnitude;
+    return true;
+}
+
+bool jsonParseDouble(const char* text, unsigned long length, double& value) {
+    return parseFloating(text, length, value);
+}
+
+bool jsonParseFloat(const char* text, unsigned long length, float& value) {
+    return parseFloating(text, length, value);
+}
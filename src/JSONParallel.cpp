@@ -0,0 +1,85 @@
+#include "JSONParallel.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+//Minimal count of elements in chunk, smaller chunks cost more for synchronization than for decoding
+const unsigned long minimalGrain = 16;
+//Count of chunks per thread, several chunks let threads that got cheap elements help the other ones
+const unsigned long chunksPerThread = 8;
+
+JSONParallelDecoder::JSONParallelDecoder(CodableThreadPool* pool) {
+    this->pool = pool;
+    for (unsigned i = 0; i < pool->size(); i++) {
+        workers.push_back(new JSONRecordParser());
+    }
+}
+
+JSONParallelDecoder::~JSONParallelDecoder() {
+    for (JSONRecordParser* worker : workers) {
+        delete worker;
+    }
+}
+
+unsigned long JSONParallelDecoder::grain(unsigned long count) const {
+    return max(minimalGrain, count / (pool->size() * chunksPerThread));
+}
+
+const char* JSONParallelDecoder::findElements(JSONDecodeContainer* array) {
+    //Boundaries of elements are found by structural scanner in one pass, elements aren't parsed here
+    JSONElementReader reader(array);
+    JSONSpan span;
+    spans.clear();
+    while (reader.nextSpan(span)) {
+        spans.push_back(span);
+    }
+    return array->source + array->contentSpan.offset;
+}
+
+void JSONParallelDecoder::shareStats(JSONDecodeContainer* array) {
+#ifdef CODABLE_ENABLE_STATS
+    for (JSONRecordParser* worker : workers) {
+        worker->parser.setStats(array->stats);
+    }
+#endif
+}
+
+JSONParallelEncoder::JSONParallelEncoder(CodableThreadPool* pool) {
+    this->pool = pool;
+}
+
+unsigned long JSONParallelEncoder::grain(unsigned long count) const {
+    return max(minimalGrain, count / (pool->size() * chunksPerThread));
+}
+
+void JSONParallelEncoder::writePieces(JSONEncodeContainer& container) {
+    unsigned long chunks = offsets.size() - 1;
+    string& text = container.text();
+    text += '[';
+    if (container.sink != NULL) {
+        //Text before array is written first, then pieces go to sink as they are
+        container.flush(true);
+        for (unsigned long chunk = 0; chunk < chunks; chunk++) {
+            if (!pieces[chunk].empty()) {
+                CODABLE_STAT(container.currentStats(), bytesWritten, pieces[chunk].length());
+                container.sink->write(pieces[chunk].data(), pieces[chunk].length());
+            }
+        }
+    } else {
+        unsigned long start = text.length();
+        text.resize(start + offsets[chunks]);
+        char* output = &text[0] + start;
+        pool->parallelFor(chunks, 1, [&](unsigned worker, unsigned long begin, unsigned long end) {
+            for (unsigned long chunk = begin; chunk < end; chunk++) {
+                memcpy(output + offsets[chunk], pieces[chunk].data(), pieces[chunk].length());
+            }
+        });
+    }
+    if (container.format.style == JSONFormatStyle::pretty && offsets[chunks] > 0) {
+        text += '\n';
+        text.append(container.depth * container.format.indent, ' ');
+    }
+    text += ']';
+    container.flush();
+}
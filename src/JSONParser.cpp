@@ -0,0 +1,231 @@
+#include "JSONParser.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//Count of characters that are scanned to tape at once (multiple of scanner block size)
+const unsigned long parserWindowSize = 1 << 14;
+
+//Checking if character is JSON whitespace
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+JSONParser::JSONParser(Arena* arena) {
+    this->arena = arena;
+    this->source = NULL;
+    this->last = -1;
+    this->root = NULL;
+    this->maxDepth = 0;
+    this->lazy = false;
+    this->stats = NULL;
+    this->skippedDepth = 0;
+}
+
+JSONDecodeContainer* JSONParser::parse(const char* content, unsigned long length) {
+    return parseRange(content, 0, length);
+}
+
+void JSONParser::expand(JSONDecodeContainer* container) {
+    //Text of container is parsed as separate document, its children are taken by container
+    JSONDecodeContainer* parsed = parseRange(container->source, container->contentSpan.offset, container->contentSpan.offset + container->contentSpan.length);
+    container->children = parsed->children;
+    container->childrenCount = parsed->childrenCount;
+    container->expander = NULL;
+}
+
+JSONDecodeContainer* JSONParser::parseRange(const char* source, unsigned long begin, unsigned long end) {
+    this->source = source;
+    last = (long)begin - 1;
+    root = NULL;
+    frames.clear();
+    children.clear();
+    skippedDepth = 0;
+    pendingKey.offset = pendingKey.length = 0;
+
+    //Scanning content once by windows, strings are skipped by scanner with respect to escaped characters
+    scanner.begin();
+    tape.resize(parserWindowSize);
+    for (unsigned long start = begin; start < end; start += parserWindowSize) {
+        unsigned long count = scanWindow(start, min(parserWindowSize, end - start));
+        CODABLE_STAT_TIME(stats, treeBuildTime);
+        for (unsigned long i = 0; i < count; i++) {
+            structural(start + tape[i]);
+        }
+    }
+
+    //Value after the last structural character (the whole content if there is no any)
+    addVariable(last + 1, end);
+    //Closing containers that are left opened in malformed content
+    if (skippedDepth > 0) {
+        closeSkipped(end - 1);
+    }
+    while (!frames.empty()) {
+        closeContainer(end - 1);
+    }
+    //Empty content is decoded as empty variable
+    if (root == NULL) {
+        root = createContainer(JSONContainerType::variable);
+    }
+
+    this->source = NULL;
+    JSONDecodeContainer* result = root;
+    root = NULL;
+    return result;
+}
+
+unsigned long JSONParser::scanWindow(unsigned long start, unsigned long length) {
+    CODABLE_STAT_TIME(stats, tokenizeTime);
+    CODABLE_STAT(stats, bytesScanned, length);
+    return scanner.scan(source + start, length, tape.data());
+}
+
+void JSONParser::structural(unsigned long position) {
+    const char* content = source;
+    unsigned long begin = last + 1;
+    if (skippedDepth > 0) {
+        //Only brackets are counted inside of container that isn't expanded
+        switch (content[position]) {
+        case '{':
+        case '[':
+            skippedDepth++;
+            break;
+        case '}':
+        case ']':
+            if (--skippedDepth == 0) {
+                closeSkipped(position);
+            }
+            break;
+        }
+        last = position;
+        return;
+    }
+    switch (content[position]) {
+    case '{':
+        openContainer(JSONContainerType::closure, position);
+        break;
+    case '[':
+        openContainer(JSONContainerType::array, position);
+        break;
+    case ':': {
+        //Text before colon is a key of the next value
+        unsigned long end = position;
+        while (begin < end && isWhitespace(content[begin])) begin++;
+        while (end > begin && isWhitespace(content[end - 1])) end--;
+        //Removing quotes from key
+        if (end - begin > 1 && content[begin] == '\"') {
+            begin++;
+            end--;
+        }
+        pendingKey.offset = begin;
+        pendingKey.length = end - begin;
+        break;
+    }
+    case ',':
+        addVariable(begin, position);
+        break;
+    case '}':
+    case ']':
+        addVariable(begin, position);
+        closeContainer(position);
+        break;
+    }
+    last = position;
+}
+
+void JSONParser::addVariable(unsigned long begin, unsigned long end) {
+    const char* content = source;
+    while (begin < end && isWhitespace(content[begin])) begin++;
+    while (end > begin && isWhitespace(content[end - 1])) end--;
+    //Empty value appears between closing bracket and comma or in empty containers
+    if (begin == end) {
+        return;
+    }
+    JSONDecodeContainer* container = createContainer(JSONContainerType::variable);
+    container->contentSpan.offset = begin;
+    container->contentSpan.length = end - begin;
+    attach(container);
+}
+
+void JSONParser::openContainer(JSONContainerType type, unsigned long position) {
+    unsigned long depth = lazy ? 1 : maxDepth;
+    if (depth > 0 && frames.size() >= depth) {
+        skipped.container = createContainer(type);
+        if (lazy) {
+            skipped.container->expander = this;
+        }
+        skipped.position = position;
+        skippedDepth = 1;
+        return;
+    }
+    Frame frame;
+    frame.container = createContainer(type);
+    frame.firstChild = children.size();
+    frame.position = position;
+    frames.push_back(frame);
+}
+
+void JSONParser::closeContainer(unsigned long position) {
+    //Closing bracket without opened container is ignored
+    if (frames.empty()) {
+        return;
+    }
+    Frame frame = frames.back();
+    frames.pop_back();
+
+    JSONDecodeContainer* container = frame.container;
+    //Children are copied from the stack to array of exact size, so the stack is reused by the next containers
+    unsigned long count = children.size() - frame.firstChild;
+    if (count > 0) {
+        container->children = arena->allocate<JSONDecodeContainer*>(count);
+        CODABLE_STAT(stats, allocations, 1);
+        memcpy(container->children, children.data() + frame.firstChild, count * sizeof(JSONDecodeContainer*));
+        container->childrenCount = count;
+    }
+    //Span of closure or array includes its brackets
+    container->contentSpan.offset = frame.position;
+    container->contentSpan.length = position - frame.position + 1;
+    children.resize(frame.firstChild);
+
+    attach(container);
+}
+
+void JSONParser::closeSkipped(unsigned long position) {
+    JSONDecodeContainer* container = skipped.container;
+    container->contentSpan.offset = skipped.position;
+    container->contentSpan.length = position - skipped.position + 1;
+    skippedDepth = 0;
+    attach(container);
+}
+
+void JSONParser::attach(JSONDecodeContainer* container) {
+    if (frames.empty()) {
+        if (root == NULL) {
+            root = container;
+        }
+        return;
+    }
+    children.push_back(container);
+}
+
+JSONDecodeContainer* JSONParser::createContainer(JSONContainerType type) {
+    JSONDecodeContainer* container = new (arena->allocate<JSONDecodeContainer>(1)) JSONDecodeContainer(arena);
+    CODABLE_STAT(stats, nodesCreated, 1);
+    CODABLE_STAT(stats, allocations, 1);
+#ifdef CODABLE_ENABLE_STATS
+    container->stats = stats;
+#endif
+    container->parsedType = type;
+    container->source = source;
+    //Only children of closures have keys
+    if (!frames.empty() && frames.back().container->parsedType == JSONContainerType::closure) {
+        container->keySpan = pendingKey;
+        container->keyEscaped = memchr(source + pendingKey.offset, '\\', pendingKey.length) != NULL;
+    }
+    pendingKey.offset = pendingKey.length = 0;
+    return container;
+}
@@ -0,0 +1,335 @@
+#include "JSONKey.hpp"
+#include "JSONNumber.hpp"
+#include "JSONPlan.hpp"
+#include "JSONString.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+//Count of characters that are scanned to tape at once (multiple of scanner block size)
+const unsigned long planWindowSize = 1 << 14;
+
+//Checking if character is JSON whitespace
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void JSONDecodePlan::add(const char* key, unsigned long offset, void (*read)(JSONPlanDecoder&, void*)) {
+    Field field;
+    field.key = key;
+    field.length = strlen(key);
+    field.hash = jsonKeyHash(key, field.length);
+    field.offset = offset;
+    field.read = read;
+    fields.push_back(field);
+}
+
+void JSONDecodePlan::finish() {
+    //Hash table with open addressing, its size is power of two at least twice bigger than count of fields
+    unsigned long size = 1;
+    while (size < fields.size() * 2) {
+        size <<= 1;
+    }
+    index.assign(size, 0);
+    for (unsigned long i = 0; i < fields.size(); i++) {
+        unsigned long slot = fields[i].hash & (size - 1);
+        while (index[slot]) {
+            slot = (slot + 1) & (size - 1);
+        }
+        index[slot] = i + 1;
+    }
+}
+
+const JSONDecodePlan::Field* JSONDecodePlan::find(const char* key, unsigned long length, unsigned long& cursor) const {
+    //Fast path: the field that follows the last found one
+    if (cursor < fields.size()) {
+        const Field& field = fields[cursor];
+        if (field.length == length && memcmp(field.key, key, length) == 0) {
+            cursor++;
+            return &field;
+        }
+    }
+    unsigned long mask = index.size() - 1;
+    for (unsigned long slot = jsonKeyHash(key, length) & mask; index[slot]; slot = (slot + 1) & mask) {
+        const Field& field = fields[index[slot] - 1];
+        if (field.length == length && memcmp(field.key, key, length) == 0) {
+            cursor = index[slot];
+            return &field;
+        }
+    }
+    return NULL;
+}
+
+JSONPlanDecoder::JSONPlanDecoder() {
+    this->text = NULL;
+    this->length = 0;
+    this->scanned = 0;
+    this->windowStart = 0;
+    this->tapeIndex = 0;
+    this->tapeCount = 0;
+    this->last = -1;
+    this->terminator = 0;
+    this->failed = false;
+}
+
+void JSONPlanDecoder::begin(const char* text, unsigned long length) {
+    this->text = text;
+    this->length = length;
+    scanned = 0;
+    windowStart = 0;
+    tapeIndex = 0;
+    tapeCount = 0;
+    last = -1;
+    terminator = 0;
+    failed = false;
+    scanner.begin();
+}
+
+bool JSONPlanDecoder::peek(unsigned long& position) {
+    while (tapeIndex == tapeCount) {
+        if (scanned >= length) {
+            return false;
+        }
+        windowStart = scanned;
+        scanned = min(windowStart + planWindowSize, length);
+        tape.resize(planWindowSize);
+        tapeCount = scanner.scan(text + windowStart, scanned - windowStart, tape.data());
+        tapeIndex = 0;
+    }
+    position = windowStart + tape[tapeIndex];
+    return true;
+}
+
+bool JSONPlanDecoder::next(unsigned long& position) {
+    if (!peek(position)) {
+        return false;
+    }
+    tapeIndex++;
+    return true;
+}
+
+bool JSONPlanDecoder::beginScalar(JSONSpan& span) {
+    unsigned long position;
+    bool found = next(position);
+    unsigned long begin = last + 1, end = found ? position : length;
+    while (begin < end && isWhitespace(text[begin])) begin++;
+    while (end > begin && isWhitespace(text[end - 1])) end--;
+    terminator = found ? text[position] : 0;
+    if (found) {
+        last = position;
+    }
+    if (begin < end) {
+        span.offset = begin;
+        span.length = end - begin;
+        if (terminator == '{' || terminator == '[' || terminator == ':') {
+            //Value is followed by something other than separator or closing bracket
+            failed = true;
+            terminator = 0;
+        }
+        return true;
+    }
+    if (terminator == '{' || terminator == '[') {
+        skipNested();
+        readTerminator();
+    }
+    return false;
+}
+
+bool JSONPlanDecoder::beginNested(char bracket) {
+    unsigned long position;
+    if (!peek(position)) {
+        //Scalar at the end of text
+        JSONSpan span;
+        beginScalar(span);
+        return false;
+    }
+    if (text[position] == bracket) {
+        unsigned long begin = last + 1;
+        while (begin < position && isWhitespace(text[begin])) begin++;
+        if (begin == position) {
+            tapeIndex++;
+            last = position;
+            return true;
+        }
+    }
+    //Scalar or closure or array of other type is skipped
+    JSONSpan span;
+    beginScalar(span);
+    return false;
+}
+
+bool JSONPlanDecoder::closes(char bracket) {
+    unsigned long position;
+    if (!peek(position) || text[position] != bracket) {
+        return false;
+    }
+    for (unsigned long i = last + 1; i < position; i++) {
+        if (!isWhitespace(text[i])) {
+            return false;
+        }
+    }
+    tapeIndex++;
+    last = position;
+    return true;
+}
+
+void JSONPlanDecoder::readTerminator() {
+    unsigned long position;
+    if (next(position)) {
+        terminator = text[position];
+        last = position;
+    } else {
+        terminator = 0;
+    }
+}
+
+unsigned long JSONPlanDecoder::skipNested() {
+    unsigned long depth = 1, position;
+    while (next(position)) {
+        switch (text[position]) {
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            depth--;
+            break;
+        }
+        if (depth == 0) {
+            last = position;
+            return position;
+        }
+    }
+    //Closing bracket is missing
+    failed = true;
+    last = length - 1;
+    return length - 1;
+}
+
+bool JSONPlanDecoder::readText(JSONSpan& span) {
+    unsigned long position;
+    if (peek(position) && (text[position] == '{' || text[position] == '[')) {
+        unsigned long begin = last + 1;
+        while (begin < position && isWhitespace(text[begin])) begin++;
+        if (begin == position) {
+            tapeIndex++;
+            last = position;
+            span.offset = position;
+            span.length = skipNested() - position + 1;
+            readTerminator();
+            return true;
+        }
+    }
+    return beginScalar(span);
+}
+
+void JSONPlanDecoder::readFields(const JSONDecodePlan& plan, void* object) {
+    if (!closes('}')) {
+        unsigned long cursor = 0;
+        do {
+            unsigned long position;
+            if (!next(position) || text[position] != ':') {
+                //Every field must have key
+                failed = true;
+                terminator = 0;
+                return;
+            }
+            unsigned long begin = last + 1, end = position;
+            last = position;
+            while (begin < end && isWhitespace(text[begin])) begin++;
+            while (end > begin && isWhitespace(text[end - 1])) end--;
+            //Removing quotes from key
+            if (end - begin > 1 && text[begin] == '\"') {
+                begin++;
+                end--;
+            }
+            const JSONDecodePlan::Field* field;
+            //Keys with escapes are compared in unescaped form
+            if (memchr(text + begin, '\\', end - begin) != NULL) {
+                key.clear();
+                jsonUnescape(text + begin, end - begin, key);
+                field = plan.find(key.data(), key.length(), cursor);
+            } else {
+                field = plan.find(text + begin, end - begin, cursor);
+            }
+            if (field != NULL) {
+                field->read(*this, (char*)object + field->offset);
+            } else {
+                JSONSpan span;
+                readText(span);
+            }
+        } while (terminator == ',');
+        failed = failed || terminator != '}';
+    }
+    readTerminator();
+}
+
+//Scalar values are parsed with the same functions as in JSONDecodeContainer, so results are the same
+
+void JSONPlanDecoder::readValue(bool& value) {
+    JSONSpan span;
+    if (beginScalar(span)) {
+        value = span.length == 4 && memcmp(text + span.offset, "true", 4) == 0;
+    }
+}
+
+void JSONPlanDecoder::readValue(int& value) {
+    JSONSpan span;
+    long long result;
+    if (beginScalar(span) && jsonParseInteger(text + span.offset, span.length, result)
+        && result >= numeric_limits<int>::min() && result <= numeric_limits<int>::max()) {
+        value = (int)result;
+    }
+}
+
+void JSONPlanDecoder::readValue(long long& value) {
+    JSONSpan span;
+    if (beginScalar(span)) {
+        jsonParseInteger(text + span.offset, span.length, value);
+    }
+}
+
+void JSONPlanDecoder::readValue(unsigned long long& value) {
+    JSONSpan span;
+    if (beginScalar(span)) {
+        jsonParseUnsigned(text + span.offset, span.length, value);
+    }
+}
+
+bool JSONPlanDecoder::parseInteger(const JSONSpan& span, long long& value) {
+    return jsonParseInteger(text + span.offset, span.length, value);
+}
+
+bool JSONPlanDecoder::parseInteger(const JSONSpan& span, unsigned long long& value) {
+    return jsonParseUnsigned(text + span.offset, span.length, value);
+}
+
+void JSONPlanDecoder::readValue(float& value) {
+    JSONSpan span;
+    if (beginScalar(span)) {
+        jsonParseFloat(text + span.offset, span.length, value);
+    }
+}
+
+void JSONPlanDecoder::readValue(double& value) {
+    JSONSpan span;
+    if (beginScalar(span)) {
+        jsonParseDouble(text + span.offset, span.length, value);
+    }
+}
+
+void JSONPlanDecoder::readValue(string& value) {
+    JSONSpan span;
+    if (!readText(span)) {
+        return;
+    }
+    if (span.length > 1) {
+        value.clear();
+        jsonUnescape(text + span.offset + 1, span.length - 2, value);
+    } else {
+        value.assign(text + span.offset, span.length);
+    }
+}
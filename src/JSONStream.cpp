@@ -0,0 +1,205 @@
+#include "JSONStream.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+//Count of characters that are scanned to tape at once (multiple of scanner block size)
+const unsigned long streamWindowSize = 1 << 14;
+//Size of scanner block, only whole blocks are scanned until the end of text
+const unsigned long streamBlockSize = 64;
+
+//Checking if character is JSON whitespace
+static inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+JSONArrayStream::JSONArrayStream() {
+    reset();
+}
+
+void JSONArrayStream::reset() {
+    scanner.begin();
+    buffer.clear();
+    scanned = 0;
+    elementStart = 0;
+    depth = 0;
+    state = State::before;
+}
+
+bool JSONArrayStream::feed(const char* data, unsigned long length) {
+    if (state == State::malformed) {
+        return false;
+    }
+    buffer.append(data, length);
+    scan((buffer.length() - scanned) / streamBlockSize * streamBlockSize);
+
+    //Dropping processed text, only unfinished element and not scanned tail are kept
+    unsigned long processed = state == State::inside ? elementStart : scanned;
+    if (processed > 0) {
+        buffer.erase(0, processed);
+        scanned -= processed;
+        elementStart -= min(elementStart, processed);
+    }
+    return state != State::malformed;
+}
+
+bool JSONArrayStream::finish() {
+    if (state != State::malformed) {
+        scan(buffer.length() - scanned);
+    }
+    bool finished = state == State::after;
+    reset();
+    return finished;
+}
+
+void JSONArrayStream::scan(unsigned long length) {
+    tape.resize(streamWindowSize);
+    unsigned long end = scanned + length;
+    while (scanned < end && state != State::malformed) {
+        unsigned long start = scanned;
+        unsigned long count = scanner.scan(buffer.data() + start, min(streamWindowSize, end - start), tape.data());
+        scanned = start + min(streamWindowSize, end - start);
+        for (unsigned long i = 0; i < count && state != State::malformed; i++) {
+            structural(start + tape[i]);
+        }
+    }
+}
+
+void JSONArrayStream::structural(unsigned long position) {
+    char c = buffer[position];
+    if (state != State::inside) {
+        //Only the highest array is expected outside of it
+        if (state == State::before && c == '[') {
+            state = State::inside;
+            depth = 1;
+            elementStart = position + 1;
+        } else {
+            state = State::malformed;
+        }
+        return;
+    }
+    switch (c) {
+    case '{':
+    case '[':
+        depth++;
+        break;
+    case '}':
+    case ']':
+        depth--;
+        if (depth == 0) {
+            if (c != ']') {
+                state = State::malformed;
+                break;
+            }
+            emit(position);
+            state = State::after;
+        }
+        break;
+    case ',':
+        if (depth == 1) {
+            emit(position);
+            elementStart = position + 1;
+        }
+        break;
+    }
+}
+
+void JSONArrayStream::emit(unsigned long end) {
+    unsigned long begin = elementStart;
+    while (begin < end && isWhitespace(buffer[begin])) begin++;
+    while (end > begin && isWhitespace(buffer[end - 1])) end--;
+    if (begin < end) {
+        element(buffer.data() + begin, end - begin);
+    }
+}
+
+JSONElementReader::JSONElementReader(JSONDecodeContainer* array) : JSONElementReader::JSONElementReader(NULL, 0) {
+    if (array->childrenCount > 0) {
+        this->array = array;
+    } else if (array->parsedType == JSONContainerType::array) {
+        //Array that isn't expanded by parser (or empty one) is read from its text
+        this->text = array->source + array->contentSpan.offset;
+        this->length = array->contentSpan.length;
+    }
+}
+
+JSONElementReader::JSONElementReader(const char* text, unsigned long length) : parser(&arena) {
+    this->array = NULL;
+    this->index = 0;
+    this->text = text;
+    this->length = length;
+    this->scanned = 0;
+    this->windowStart = 0;
+    this->tapeIndex = 0;
+    this->tapeCount = 0;
+    this->elementStart = 0;
+    this->depth = 0;
+    scanner.begin();
+}
+
+JSONDecodeContainer* JSONElementReader::next() {
+    if (array != NULL) {
+        return index < array->childrenCount ? array->children[index++] : NULL;
+    }
+    JSONSpan span;
+    if (!nextSpan(span)) {
+        return NULL;
+    }
+    //Containers of previous element are released, their memory is reused
+    arena.reset();
+    return parser.parse(text + span.offset, span.length);
+}
+
+bool JSONElementReader::nextStructural(unsigned long& position) {
+    while (tapeIndex == tapeCount) {
+        if (scanned >= length) {
+            return false;
+        }
+        windowStart = scanned;
+        scanned = min(windowStart + streamWindowSize, length);
+        tape.resize(streamWindowSize);
+        tapeCount = scanner.scan(text + windowStart, scanned - windowStart, tape.data());
+        tapeIndex = 0;
+    }
+    position = windowStart + tape[tapeIndex++];
+    return true;
+}
+
+bool JSONElementReader::nextSpan(JSONSpan& span) {
+    unsigned long position;
+    while (nextStructural(position)) {
+        char c = text[position];
+        if (depth == 0) {
+            //Only the highest array is expected outside of it
+            if (c != '[' || elementStart > 0) {
+                return false;
+            }
+            depth = 1;
+            elementStart = position + 1;
+            continue;
+        }
+        switch (c) {
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            depth--;
+            break;
+        }
+        if ((depth == 1 && c == ',') || depth == 0) {
+            unsigned long begin = elementStart, end = position;
+            elementStart = position + 1;
+            while (begin < end && isWhitespace(text[begin])) begin++;
+            while (end > begin && isWhitespace(text[end - 1])) end--;
+            if (begin < end) {
+                span.offset = begin;
+                span.length = end - begin;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,253 @@
+#include "JSONString.hpp"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define CODABLE_X86_SIMD
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+//UTF-8 of replacement character U+FFFD
+static const char replacement[] = "\xEF\xBF\xBD";
+
+//Escapes of control characters, zero for characters that are written as \u00XX
+static const char shortEscapes[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const char hexDigits[] = "0123456789abcdef";
+
+//Count of characters from the start of text that are copied to escaped text as they are
+//Such characters are ASCII except quote, backslash and control characters
+static inline unsigned long plainForEscape(const unsigned char* text, unsigned long length) {
+    unsigned long position = 0;
+#ifdef CODABLE_X86_SIMD
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    //Signed comparison catches both control characters and bytes of non-ASCII characters (they are negative)
+    const __m128i space = _mm_set1_epi8(0x20);
+    for (; position + 16 <= length; position += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(text + position));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), _mm_cmplt_epi8(chunk, space));
+        unsigned mask = (unsigned)_mm_movemask_epi8(special);
+        if (mask != 0) {
+            return position + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while (position < length) {
+        unsigned char c = text[position];
+        if (c < 0x20 || c >= 0x80 || c == '\"' || c == '\\') {
+            break;
+        }
+        position++;
+    }
+    return position;
+}
+
+//Count of characters from the start of text that are copied to unescaped text as they are (ASCII except backslash)
+static inline unsigned long plainForUnescape(const unsigned char* text, unsigned long length) {
+    unsigned long position = 0;
+#ifdef CODABLE_X86_SIMD
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; position + 16 <= length; position += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(text + position));
+        //High bit of every byte of non-ASCII characters is set
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, backslash), chunk));
+        if (mask != 0) {
+            return position + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while (position < length && text[position] != '\\' && text[position] < 0x80) {
+        position++;
+    }
+    return position;
+}
+
+//Length of valid UTF-8 sequence at the start of text (RFC 3629), 0 if sequence is invalid
+static unsigned long utf8Length(const unsigned char* text, unsigned long length) {
+    unsigned char c = text[0];
+    unsigned long count;
+    unsigned char low = 0x80, high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        count = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        count = 3;
+        //Overlong forms and surrogates are not allowed
+        if (c == 0xE0) low = 0xA0;
+        if (c == 0xED) high = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        count = 4;
+        //Overlong forms and code points after U+10FFFF are not allowed
+        if (c == 0xF0) low = 0x90;
+        if (c == 0xF4) high = 0x8F;
+    } else {
+        return 0;
+    }
+    if (count > length || text[1] < low || text[1] > high) {
+        return 0;
+    }
+    for (unsigned long i = 2; i < count; i++) {
+        if (text[i] < 0x80 || text[i] > 0xBF) {
+            return 0;
+        }
+    }
+    return count;
+}
+
+//Appending code point as UTF-8
+static void appendUTF8(unsigned codePoint, string& output) {
+    if (codePoint < 0x80) {
+        output += (char)codePoint;
+    } else if (codePoint < 0x800) {
+        output += (char)(0xC0 | (codePoint >> 6));
+        output += (char)(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        output += (char)(0xE0 | (codePoint >> 12));
+        output += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        output += (char)(0x80 | (codePoint & 0x3F));
+    } else {
+        output += (char)(0xF0 | (codePoint >> 18));
+        output += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        output += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        output += (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+//Parsing 4 hexadecimal digits, returns false if some of them is not a digit
+static bool parseHex4(const char* text, unsigned& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = text[i];
+        unsigned digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    return true;
+}
+
+bool jsonEscape(const char* text, unsigned long length, string& output) {
+    const unsigned char* data = (const unsigned char*)text;
+    bool valid = true;
+    unsigned long position = 0;
+    while (position < length) {
+        unsigned long plain = plainForEscape(data + position, length - position);
+        output.append(text + position, plain);
+        position += plain;
+        if (position == length) {
+            break;
+        }
+        unsigned char c = data[position];
+        if (c >= 0x80) {
+            unsigned long sequence = utf8Length(data + position, length - position);
+            if (sequence == 0) {
+                output.append(replacement, 3);
+                valid = false;
+                position++;
+            } else {
+                output.append(text + position, sequence);
+                position += sequence;
+            }
+            continue;
+        }
+        output += '\\';
+        if (c == '\"' || c == '\\') {
+            output += (char)c;
+        } else if (shortEscapes[c]) {
+            output += shortEscapes[c];
+        } else {
+            output += "u00";
+            output += hexDigits[c >> 4];
+            output += hexDigits[c & 15];
+        }
+        position++;
+    }
+    return valid;
+}
+
+bool jsonUnescape(const char* text, unsigned long length, string& output) {
+    const unsigned char* data = (const unsigned char*)text;
+    bool valid = true;
+    unsigned long position = 0;
+    while (position < length) {
+        unsigned long plain = plainForUnescape(data + position, length - position);
+        output.append(text + position, plain);
+        position += plain;
+        if (position == length) {
+            break;
+        }
+        if (data[position] >= 0x80) {
+            unsigned long sequence = utf8Length(data + position, length - position);
+            if (sequence == 0) {
+                output.append(replacement, 3);
+                valid = false;
+                position++;
+            } else {
+                output.append(text + position, sequence);
+                position += sequence;
+            }
+            continue;
+        }
+        //Backslash at the end of text is copied
+        if (position + 1 == length) {
+            output += '\\';
+            valid = false;
+            break;
+        }
+        char escape = text[position + 1];
+        position += 2;
+        switch (escape) {
+        case '\"': output += '\"'; break;
+        case '\\': output += '\\'; break;
+        case '/': output += '/'; break;
+        case 'b': output += '\b'; break;
+        case 'f': output += '\f'; break;
+        case 'n': output += '\n'; break;
+        case 'r': output += '\r'; break;
+        case 't': output += '\t'; break;
+        case 'u': {
+            unsigned codePoint;
+            if (position + 4 > length || !parseHex4(text + position, codePoint)) {
+                output += "\\u";
+                valid = false;
+                break;
+            }
+            position += 4;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                //High surrogate must be followed by low one, together they encode code point after U+FFFF
+                unsigned low;
+                if (position + 6 <= length && text[position] == '\\' && text[position + 1] == 'u' &&
+                    parseHex4(text + position + 2, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                    position += 6;
+                    appendUTF8(0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00), output);
+                } else {
+                    output.append(replacement, 3);
+                    valid = false;
+                }
+            } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                output.append(replacement, 3);
+                valid = false;
+            } else {
+                appendUTF8(codePoint, output);
+            }
+            break;
+        }
+        default:
+            output += '\\';
+            output += escape;
+            valid = false;
+            break;
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,235 @@
+#include "JSONStructural.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define CODABLE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+typedef unsigned long long Mask;
+
+const unsigned long blockSize = 64;
+
+//Character classes for scalar classification
+const unsigned char quoteClass = 1;
+const unsigned char backslashClass = 2;
+const unsigned char structuralClass = 4;
+
+static inline int trailingZeros(Mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int count = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+//Every bit becomes XOR of itself and all lower bits, so bits between opening and closing quotes are set
+static inline Mask prefixXor(Mask mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+//Bits of characters that are escaped by backslash (the ones after odd sequences of backslashes)
+//escaped is carried between blocks: it is 1 if the first character of the next block is escaped
+static inline Mask findEscaped(Mask backslash, Mask& escaped) {
+    if (backslash == 0) {
+        Mask result = escaped;
+        escaped = 0;
+        return result;
+    }
+    //Backslash that is escaped itself doesn't start sequence
+    backslash &= ~escaped;
+    Mask followsEscape = backslash << 1 | escaped;
+    const Mask evenBits = 0x5555555555555555ULL;
+    Mask oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+    //Adding sequence starts to backslashes carries the bit to the end of every sequence
+    Mask sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    escaped = sequencesStartingOnEvenBits < backslash ? 1 : 0;
+    Mask invertMask = sequencesStartingOnEvenBits << 1;
+    return (evenBits ^ invertMask) & followsEscape;
+}
+
+//Removing structural characters that are inside of strings and writing positions of the rest
+static inline unsigned long finishBlock(Mask strings, Mask structural, Mask& inString, unsigned offset, unsigned* positions) {
+    strings ^= inString;
+    //All ones if block ends inside of string
+    inString = (Mask)((long long)strings >> 63);
+    structural &= ~strings;
+
+    unsigned long count = 0;
+    while (structural) {
+        positions[count++] = offset + trailingZeros(structural);
+        structural &= structural - 1;
+    }
+    return count;
+}
+
+struct ScalarClasses {
+    unsigned char table[256];
+
+    ScalarClasses() {
+        memset(table, 0, sizeof(table));
+        table[(unsigned char)'\"'] = quoteClass;
+        table[(unsigned char)'\\'] = backslashClass;
+        const char* structurals = "{}[]:,";
+        for (const char* c = structurals; *c; c++) {
+            table[(unsigned char)*c] = structuralClass;
+        }
+    }
+};
+
+static const ScalarClasses scalarClasses;
+
+static unsigned long scanScalar(const char* data, unsigned long blocks, unsigned offset, unsigned* positions, Mask& inString, Mask& escaped) {
+    unsigned long count = 0;
+    for (unsigned long block = 0; block < blocks; block++, data += blockSize, offset += blockSize) {
+        Mask quote = 0, backslash = 0, structural = 0;
+        for (unsigned i = 0; i < blockSize; i++) {
+            unsigned char type = scalarClasses.table[(unsigned char)data[i]];
+            quote |= (Mask)(type & quoteClass) << i;
+            backslash |= (Mask)((type & backslashClass) >> 1) << i;
+            structural |= (Mask)((type & structuralClass) >> 2) << i;
+        }
+        quote &= ~findEscaped(backslash, escaped);
+        count += finishBlock(prefixXor(quote), structural, inString, offset, positions + count);
+    }
+    return count;
+}
+
+#ifdef CODABLE_X86_SIMD
+
+static unsigned long scanSSE2(const char* data, unsigned long blocks, unsigned offset, unsigned* positions, Mask& inString, Mask& escaped) {
+    const __m128i quoteCharacter = _mm_set1_epi8('\"');
+    const __m128i backslashCharacter = _mm_set1_epi8('\\');
+    //'[' and '{', ']' and '}' differ only in 0x20 bit
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i openBracket = _mm_set1_epi8('{');
+    const __m128i closeBracket = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+
+    unsigned long count = 0;
+    for (unsigned long block = 0; block < blocks; block++, data += blockSize, offset += blockSize) {
+        Mask quote = 0, backslash = 0, structural = 0;
+        for (int part = 0; part < 4; part++) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(data + part * 16));
+            __m128i folded = _mm_or_si128(chunk, caseBit);
+            __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, openBracket), _mm_cmpeq_epi8(folded, closeBracket));
+            __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma));
+            quote |= (Mask)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quoteCharacter)) << (part * 16);
+            backslash |= (Mask)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslashCharacter)) << (part * 16);
+            structural |= (Mask)(unsigned)_mm_movemask_epi8(_mm_or_si128(brackets, separators)) << (part * 16);
+        }
+        quote &= ~findEscaped(backslash, escaped);
+        count += finishBlock(prefixXor(quote), structural, inString, offset, positions + count);
+    }
+    return count;
+}
+
+__attribute__((target("avx2,pclmul")))
+static unsigned long scanAVX2(const char* data, unsigned long blocks, unsigned offset, unsigned* positions, Mask& inString, Mask& escaped) {
+    const __m256i quoteCharacter = _mm256_set1_epi8('\"');
+    const __m256i backslashCharacter = _mm256_set1_epi8('\\');
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i openBracket = _mm256_set1_epi8('{');
+    const __m256i closeBracket = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m128i allOnes = _mm_set1_epi8((char)0xFF);
+
+    unsigned long count = 0;
+    for (unsigned long block = 0; block < blocks; block++, data += blockSize, offset += blockSize) {
+        Mask quote = 0, backslash = 0, structural = 0;
+        for (int part = 0; part < 2; part++) {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(data + part * 32));
+            __m256i folded = _mm256_or_si256(chunk, caseBit);
+            __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBracket), _mm256_cmpeq_epi8(folded, closeBracket));
+            __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon), _mm256_cmpeq_epi8(chunk, comma));
+            quote |= (Mask)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quoteCharacter)) << (part * 32);
+            backslash |= (Mask)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslashCharacter)) << (part * 32);
+            structural |= (Mask)(unsigned)_mm256_movemask_epi8(_mm256_or_si256(brackets, separators)) << (part * 32);
+        }
+        quote &= ~findEscaped(backslash, escaped);
+        //Carry-less multiplication by all ones is prefix XOR
+        Mask strings = (Mask)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)quote), allOnes, 0));
+        count += finishBlock(strings, structural, inString, offset, positions + count);
+    }
+    return count;
+}
+
+#endif
+
+bool jsonScanLevelSupported(JSONScanLevel level) {
+    switch (level) {
+    case JSONScanLevel::scalar:
+        return true;
+#ifdef CODABLE_X86_SIMD
+    case JSONScanLevel::sse2:
+        return true;
+    case JSONScanLevel::avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("pclmul");
+#endif
+    default:
+        return false;
+    }
+}
+
+JSONScanLevel jsonBestScanLevel() {
+    static const JSONScanLevel best = jsonScanLevelSupported(JSONScanLevel::avx2) ? JSONScanLevel::avx2 :
+        (jsonScanLevelSupported(JSONScanLevel::sse2) ? JSONScanLevel::sse2 : JSONScanLevel::scalar);
+    return best;
+}
+
+JSONStructuralScanner::JSONStructuralScanner() : JSONStructuralScanner::JSONStructuralScanner(jsonBestScanLevel()) {}
+
+JSONStructuralScanner::JSONStructuralScanner(JSONScanLevel level) {
+    //Unsupported implementation is replaced with scalar one
+    this->level = jsonScanLevelSupported(level) ? level : JSONScanLevel::scalar;
+    this->inString = 0;
+    this->escaped = 0;
+}
+
+void JSONStructuralScanner::begin() {
+    inString = 0;
+    escaped = 0;
+}
+
+//Scanning whole blocks with chosen implementation
+static unsigned long scanBlocks(JSONScanLevel level, const char* data, unsigned long blocks, unsigned offset, unsigned* positions, Mask& inString, Mask& escaped) {
+    switch (level) {
+#ifdef CODABLE_X86_SIMD
+    case JSONScanLevel::avx2:
+        return scanAVX2(data, blocks, offset, positions, inString, escaped);
+    case JSONScanLevel::sse2:
+        return scanSSE2(data, blocks, offset, positions, inString, escaped);
+#endif
+    default:
+        return scanScalar(data, blocks, offset, positions, inString, escaped);
+    }
+}
+
+unsigned long JSONStructuralScanner::scan(const char* data, unsigned long length, unsigned* positions) {
+    unsigned long blocks = length / blockSize;
+    unsigned long count = scanBlocks(level, data, blocks, 0, positions, inString, escaped);
+
+    //The last incomplete block is copied to buffer padded with spaces, they are not special characters
+    unsigned long rest = length % blockSize;
+    if (rest) {
+        char padded[blockSize];
+        memset(padded, ' ', blockSize);
+        memcpy(padded, data + blocks * blockSize, rest);
+        count += scanBlocks(level, padded, 1, (unsigned)(blocks * blockSize), positions + count, inString, escaped);
+    }
+    return count;
+}
@@ -0,0 +1,124 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+using namespace std;
+
+CodableThreadPool::CodableThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    this->job = NULL;
+    this->remaining = 0;
+    this->generation = 0;
+    this->stopping = false;
+    for (unsigned i = 0; i < threads; i++) {
+        queues.push_back(new Queue());
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        this->threads.push_back(thread(&CodableThreadPool::workerLoop, this, i));
+    }
+}
+
+CodableThreadPool::~CodableThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : threads) {
+        worker.join();
+    }
+    for (Queue* queue : queues) {
+        delete queue;
+    }
+}
+
+void CodableThreadPool::parallelFor(unsigned long count, unsigned long grain, const function<void(unsigned, unsigned long, unsigned long)>& function) {
+    if (count == 0) {
+        return;
+    }
+    grain = max(grain, 1ul);
+    unsigned long chunks = (count + grain - 1) / grain;
+    if (queues.size() == 1 || chunks == 1) {
+        function(0, 0, count);
+        return;
+    }
+
+    lock_guard<std::mutex> call(callMutex);
+    job = &function;
+    remaining = chunks;
+    //Every worker gets contiguous part of chunks, so neighbour elements are usually processed by the same thread
+    unsigned long workers = queues.size();
+    for (unsigned long i = 0; i < chunks; i++) {
+        Chunk chunk = { i * grain, min(count, (i + 1) * grain) };
+        Queue* queue = queues[i * workers / chunks];
+        lock_guard<std::mutex> lock(queue->mutex);
+        queue->chunks.push_back(chunk);
+    }
+    {
+        lock_guard<std::mutex> lock(mutex);
+        generation++;
+    }
+    wake.notify_all();
+
+    work(0);
+    unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() {
+        return remaining == 0;
+    });
+    job = NULL;
+}
+
+void CodableThreadPool::workerLoop(unsigned index) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() {
+                return stopping || generation != seen;
+            });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        work(index);
+    }
+}
+
+void CodableThreadPool::work(unsigned index) {
+    Chunk chunk;
+    while (pop(index, chunk) || steal(index, chunk)) {
+        (*job)(index, chunk.begin, chunk.end);
+        if (--remaining == 0) {
+            //Lock makes sure that calling thread is waiting or will see zero before waiting
+            lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+}
+
+bool CodableThreadPool::pop(unsigned index, Chunk& chunk) {
+    Queue* queue = queues[index];
+    lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->chunks.empty()) {
+        return false;
+    }
+    chunk = queue->chunks.back();
+    queue->chunks.pop_back();
+    return true;
+}
+
+bool CodableThreadPool::steal(unsigned index, Chunk& chunk) {
+    unsigned long workers = queues.size();
+    for (unsigned long i = 1; i < workers; i++) {
+        Queue* queue = queues[(index + i) % workers];
+        lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->chunks.empty()) {
+            chunk = queue->chunks.front();
+            queue->chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -5,6 +5,7 @@
 
 #include "Codable.hpp"
 #include "JSON.hpp"
+#include "Binary.hpp"
 #include <iostream>
 #include <math.h>
 using namespace std;
@@ -40,6 +41,12 @@ public:
             jsonContainer->encode(country_code, "country");
             jsonContainer->encode(number, "number");
             jsonContainer->encode(last_signal_level, "signal");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(country_code, "country");
+            binaryContainer->encode(number, "number");
+            binaryContainer->encode(last_signal_level, "signal");
         }
     }
     
@@ -51,6 +58,12 @@ public:
             this->country_code = jsonContainer->decode(int(), "country");
             this->number = jsonContainer->decode(0LL, "number");
             this->last_signal_level = jsonContainer->decode(float(), "signal");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer* binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            this->country_code = binaryContainer->decode(int(), "country");
+            this->number = binaryContainer->decode(0LL, "number");
+            this->last_signal_level = binaryContainer->decode(float(), "signal");
         }
     }
     
@@ -99,6 +112,12 @@ public:
             jsonContainer->encode(name, "name");
             jsonContainer->encode(phone_number, "phone_number");
             jsonContainer->encode(is_valid, "is_valid");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(name, "name");
+            binaryContainer->encode(phone_number, "phone_number");
+            binaryContainer->encode(is_valid, "is_valid");
         }
     }
     
@@ -110,6 +129,12 @@ public:
             name = jsonContainer->decode(string(), "name");
             phone_number = jsonContainer->decode(PhoneNumber(), "phone_number");
             is_valid = jsonContainer->decode(bool(), "is_valid");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer *binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            name = binaryContainer->decode(string(), "name");
+            phone_number = binaryContainer->decode(PhoneNumber(), "phone_number");
+            is_valid = binaryContainer->decode(bool(), "is_valid");
         }
     }
 
@@ -155,6 +180,11 @@ public:
 
             jsonContainer->encode(contacts, "contacts");
             jsonContainer->encode(time_spent, "time_spent");
+        } else if (container->type == CoderType::binary) {
+            BinaryEncodeContainer* binaryContainer = dynamic_cast<BinaryEncodeContainer*>(container);
+
+            binaryContainer->encode(contacts, "contacts");
+            binaryContainer->encode(time_spent, "time_spent");
         }
     }
 
@@ -165,6 +195,11 @@ public:
 
             contacts = jsonContainer->decode(vector<Contact>(), "contacts");
             time_spent = jsonContainer->decode(double(), "time_spent");
+        } else if (container->type == CoderType::binary) {
+            BinaryDecodeContainer* binaryContainer = dynamic_cast<BinaryDecodeContainer*>(container);
+
+            contacts = binaryContainer->decode(vector<Contact>(), "contacts");
+            time_spent = binaryContainer->decode(double(), "time_spent");
         }
     }
 
@@ -195,6 +230,385 @@ bool check_book(PhoneBook book, PhoneBook ref) {
     return true;
 }
 
+//Classes with list of fields, they are encoded to the same text as classes above
+class ReflectedNumber {
+public:
+    int country;
+    long long number;
+    float signal;
+
+    CODABLE_FIELDS(ReflectedNumber, country, number, signal)
+};
+
+class ReflectedContact {
+public:
+    string name;
+    ReflectedNumber phone_number;
+    bool is_valid;
+
+    CODABLE_FIELDS(ReflectedContact, name, phone_number, is_valid)
+};
+
+//Class with list of fields can contain classes with Codable protocol
+class ReflectedOwner {
+public:
+    ReflectedContact contact;
+    PhoneNumber backup_number;
+
+    CODABLE_FIELDS(ReflectedOwner, contact, backup_number)
+};
+
+class ReflectedBook {
+public:
+    vector<ReflectedContact> contacts;
+    double time_spent;
+
+    CODABLE_FIELDS(ReflectedBook, contacts, time_spent)
+};
+
+//Class with Codable protocol that contains class with list of fields
+class MixedBook: public Codable {
+public:
+    ReflectedOwner owner;
+    PhoneBook book;
+
+    void encode(CoderContainer* container) {
+        JSONEncodeContainer* jsonContainer = dynamic_cast<JSONEncodeContainer*>(container);
+        jsonContainer->encode(owner, "owner");
+        jsonContainer->encode(book, "book");
+    }
+
+    void decode(CoderContainer* container) {
+        JSONDecodeContainer* jsonContainer = dynamic_cast<JSONDecodeContainer*>(container);
+        owner = jsonContainer->decode(ReflectedOwner(), "owner");
+        book = jsonContainer->decode(PhoneBook(), "book");
+    }
+};
+
+//Classes with list of fields must be encoded and decoded like the same classes with Codable protocol
+bool check_fields(PhoneBook book, string reference) {
+    ReflectedBook reflected;
+    reflected.time_spent = book.time_spent;
+    for (unsigned long i = 0; i < book.contacts.size(); i++) {
+        ReflectedContact contact;
+        contact.name = book.contacts[i].name;
+        contact.phone_number.country = book.contacts[i].phone_number.country_code;
+        contact.phone_number.number = book.contacts[i].phone_number.number;
+        contact.phone_number.signal = book.contacts[i].phone_number.last_signal_level;
+        contact.is_valid = book.contacts[i].is_valid;
+        reflected.contacts.push_back(contact);
+    }
+
+    JSONEncoder encoder;
+    auto encodeContainer = encoder.container();
+    encodeContainer.encode(reflected);
+    if (encodeContainer.content != reference) {
+        cerr << "[Fields check]: wrong text: " << encodeContainer.content << '\n';
+        return false;
+    }
+
+    JSONDecoder decoder;
+    auto container = decoder.container(reference);
+    ReflectedBook decoded = container.decode(ReflectedBook());
+    if (decoded.contacts.size() != book.contacts.size() || !round_equal(decoded.time_spent, book.time_spent)) {
+        cerr << "[Fields check]: wrong decoded book\n";
+        return false;
+    }
+    for (unsigned long i = 0; i < book.contacts.size(); i++) {
+        const ReflectedContact& contact = decoded.contacts[i];
+        if (contact.name != book.contacts[i].name || contact.is_valid != book.contacts[i].is_valid || contact.phone_number.country != book.contacts[i].phone_number.country_code || contact.phone_number.number != book.contacts[i].phone_number.number) {
+            cerr << "[Fields check]: wrong decoded contact " << i << '\n';
+            return false;
+        }
+    }
+
+    //Mixing of both ways
+    MixedBook mixed;
+    mixed.owner.contact = reflected.contacts[0];
+    mixed.owner.backup_number = PhoneNumber(7, 100, 0.5);
+    mixed.book = book;
+    encodeContainer.encode(mixed);
+    auto mixedContainer = decoder.container(encodeContainer.content);
+    MixedBook decodedMixed = mixedContainer.decode(MixedBook());
+    if (decodedMixed.owner.contact.name != mixed.owner.contact.name || !check_number(decodedMixed.owner.backup_number, mixed.owner.backup_number) || !check_book(decodedMixed.book, book)) {
+        cerr << "[Fields check]: wrong mixed book: " << encodeContainer.content << '\n';
+        return false;
+    }
+    return true;
+}
+
+//Class that counts its copies
+class CopyCounter {
+public:
+    static int copies;
+    int value;
+    vector<int> values;
+
+    CODABLE_FIELDS(CopyCounter, value, values)
+
+    CopyCounter() : value(0) {}
+    CopyCounter(const CopyCounter& other) : value(other.value), values(other.values) {
+        copies++;
+    }
+    CopyCounter& operator=(const CopyCounter& other) {
+        value = other.value;
+        values = other.values;
+        copies++;
+        return *this;
+    }
+};
+
+int CopyCounter::copies = 0;
+
+//Encoding must not copy objects, decoding to existing objects must fill them in place
+bool check_no_copies() {
+    vector<CopyCounter> items(3);
+    for (int i = 0; i < 3; i++) {
+        items[i].value = i + 1;
+        items[i].values = { i, i * 2, i * 3 };
+    }
+    CopyCounter::copies = 0;
+
+    JSONEncoder encoder;
+    auto encodeContainer = encoder.container();
+    encodeContainer.encode(items);
+    if (CopyCounter::copies != 0) {
+        cerr << "[Copies check]: objects were copied " << CopyCounter::copies << " times during encoding\n";
+        return false;
+    }
+
+    JSONDecoder decoder;
+    auto container = decoder.container(encodeContainer.content);
+    vector<CopyCounter> decoded;
+    if (!container.decodeTo(decoded) || CopyCounter::copies != 0) {
+        cerr << "[Copies check]: objects were copied " << CopyCounter::copies << " times during decoding\n";
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (decoded[i].value != i + 1 || decoded[i].values != items[i].values) {
+            cerr << "[Copies check]: wrong decoded item " << i << ": " << encodeContainer.content << '\n';
+            return false;
+        }
+    }
+
+    //Missing key keeps value
+    int value = 5;
+    if (container.decodeTo(value, "missing") || value != 5) {
+        cerr << "[Copies check]: value was changed by missing key\n";
+        return false;
+    }
+    return true;
+}
+
+//Decoding of beautified JSON with tabs, line breaks and special characters inside of strings
+bool check_parser() {
+    string content = "{\n\t\"contacts\" : [\n\t\t{ \"name\" : \"Eu, \\\"gene\\\" [1]\", \"phone_number\" : { \"country\" : 7 }, \"is_valid\" : true },\r\n\t\t{ }\n\t],\n\t\"time_spent\" : 2.5\n}\n";
+    JSONDecoder decoder;
+    auto container = decoder.container(content);
+    auto book = container.decode(PhoneBook());
+    if (book.contacts.size() != 2) {
+        cerr << "[Parser check]: wrong count of contacts: " << book.contacts.size() << '\n';
+        return false;
+    }
+    if (book.contacts[0].name != "Eu, \"gene\" [1]") {
+        cerr << "[Parser check]: wrong name: " << book.contacts[0].name << '\n';
+        return false;
+    }
+    if (book.contacts[0].phone_number.country_code != 7 || !book.contacts[0].is_valid) {
+        cerr << "[Parser check]: wrong contact fields\n";
+        return false;
+    }
+    if (!round_equal(book.time_spent, 2.5)) {
+        cerr << "[Parser check]: wrong time spent: " << book.time_spent << '\n';
+        return false;
+    }
+    return true;
+}
+
+//Decoding fields of wide closure in different orders
+bool check_wide_closure() {
+    const int count = 40;
+    string content = "{";
+    for (int i = 0; i < count; i++) {
+        content += (i ? ",\"field_" : "\"field_") + to_string(i) + "\": " + to_string(i * 3);
+    }
+    content += "}";
+
+    JSONDecoder decoder;
+    auto container = decoder.container(content);
+    for (int pass = 0; pass < 3; pass++) {
+        for (int j = 0; j < count; j++) {
+            //In order, in reverse order and with a stride
+            int i = pass == 0 ? j : (pass == 1 ? count - 1 - j : (j * 7) % count);
+            int value = container.decode(int(-1), "field_" + to_string(i));
+            if (value != i * 3) {
+                cerr << "[Wide closure check]: wrong value of field_" << i << ": " << value << '\n';
+                return false;
+            }
+        }
+    }
+    if (container.decode(int(-1), "field_missing") != -1) {
+        cerr << "[Wide closure check]: missing field was found\n";
+        return false;
+    }
+    return true;
+}
+
+//Decoding many documents with one decoder, memory of arena must be reused after reset
+bool check_decoder_reset(PhoneBook book, string content) {
+    Arena arena;
+    JSONDecoder decoder(&arena);
+    unsigned long capacity = 0;
+    for (int i = 0; i < 10; i++) {
+        //Every way of passing content must reuse buffers of decoder
+        string moved = content;
+        auto container = i % 3 == 0 ? decoder.container(content) : (i % 3 == 1 ? decoder.container(content.data(), content.length()) : decoder.container(std::move(moved)));
+        if (!check_book(container.decode(PhoneBook()), book)) {
+            cerr << "[Decoder reset check]: wrong book after " << i << " resets\n";
+            return false;
+        }
+        if (i == 1) {
+            capacity = arena.capacity();
+        } else if (i > 1 && arena.capacity() != capacity) {
+            cerr << "[Decoder reset check]: arena grew after reset: " << arena.capacity() << '\n';
+            return false;
+        }
+        decoder.reset();
+    }
+    return true;
+}
+
+//Encoding many documents with one container must produce the same text every time
+bool check_encoder_reuse(PhoneBook book, string reference) {
+    JSONEncoder encoder;
+    auto container = encoder.container();
+    for (int i = 0; i < 3; i++) {
+        container.encode(book);
+        if (container.content != reference) {
+            cerr << "[Encoder reuse check]: wrong text after " << i << " documents: " << container.content << '\n';
+            return false;
+        }
+    }
+    container.reset();
+    if (!container.content.empty()) {
+        cerr << "[Encoder reuse check]: text is kept after reset\n";
+        return false;
+    }
+    return true;
+}
+
+//Sink that collects encoded pieces
+class StringSink: public CoderSink {
+public:
+    string text;
+    int writes = 0;
+
+    void write(const char* data, unsigned long length) {
+        text.append(data, length);
+        writes++;
+    }
+};
+
+//Encoding to sink must produce the same text as encoding to content
+bool check_sink(PhoneBook book, string reference) {
+    StringSink sink;
+    JSONEncoder encoder;
+    auto container = encoder.container(&sink);
+    container.encode(book);
+    if (sink.text != reference || !container.content.empty()) {
+        cerr << "[Sink check]: text written to sink is different: " << sink.text << '\n';
+        return false;
+    }
+    return true;
+}
+
+//Versions of the same class for checking compatibility of binary format
+class RecordV1 {
+public:
+    int id;
+    vector<int> values;
+
+    CODABLE_FIELDS(RecordV1, id, values)
+};
+
+class RecordV2 {
+public:
+    int id;
+    vector<int> values;
+    string comment;
+
+    CODABLE_FIELDS(RecordV2, id, values, comment)
+};
+
+//Encoding to binary format and decoding back
+bool check_binary(PhoneBook book) {
+    BinaryEncoder encoder;
+    auto encodeContainer = encoder.container();
+    encodeContainer.encode(book);
+
+    BinaryDecoder decoder;
+    auto container = decoder.container(encodeContainer.content);
+    if (encodeContainer.failed() || !check_book(container.decode(PhoneBook()), book)) {
+        cerr << "[Binary check]: wrong decoded book\n";
+        return false;
+    }
+
+    StringSink sink;
+    auto sinkContainer = encoder.container(&sink);
+    sinkContainer.encode(book);
+    if (sink.text != encodeContainer.content) {
+        cerr << "[Binary check]: data written to sink is different\n";
+        return false;
+    }
+
+    //Documents with closures longer than limit aren't written at all
+    StringSink limitedSink;
+    auto limited = encoder.container(&limitedSink);
+    limited.setClosureLimit(16);
+    limited.encode(book);
+    if (!limited.failed() || !limitedSink.text.empty() || !limited.content.empty()) {
+        cerr << "[Binary check]: document with too long closure is written\n";
+        return false;
+    }
+    limited.setClosureLimit(encodeContainer.content.size());
+    limited.encode(book);
+    if (limited.failed() || limitedSink.text != encodeContainer.content) {
+        cerr << "[Binary check]: document with closures within limit isn't written\n";
+        return false;
+    }
+
+    //New fields at the end of class are skipped by old decoders and decoded as defaults by new ones
+    vector<RecordV2> records(2);
+    records[0].id = -5;
+    records[0].values = { 1, -300, 70000 };
+    records[0].comment = "first";
+    records[1].id = 1 << 30;
+    records[1].comment = "second";
+    encodeContainer.encode(records);
+    auto newContainer = decoder.container(encodeContainer.content);
+    vector<RecordV1> oldRecords = newContainer.decode(vector<RecordV1>());
+    if (oldRecords.size() != 2 || oldRecords[0].id != -5 || oldRecords[0].values != records[0].values || oldRecords[1].id != (1 << 30)) {
+        cerr << "[Binary check]: new records are decoded wrong by old class\n";
+        return false;
+    }
+    encodeContainer.encode(oldRecords);
+    auto oldContainer = decoder.container(encodeContainer.content);
+    vector<RecordV2> newRecords = oldContainer.decode(vector<RecordV2>());
+    if (newRecords.size() != 2 || newRecords[0].values != records[0].values || !newRecords[0].comment.empty() || newRecords[1].id != (1 << 30)) {
+        cerr << "[Binary check]: old records are decoded wrong by new class\n";
+        return false;
+    }
+
+    //Truncated data must not be read out of bounds
+    string data = encodeContainer.content;
+    for (unsigned long length = 0; length < data.length(); length++) {
+        auto truncated = decoder.container(data.data(), length);
+        truncated.decode(vector<RecordV2>());
+        decoder.reset();
+    }
+    return true;
+}
+
 int main() {
     //Phone book creation
     Contact eugene = Contact("Eugene", PhoneNumber(123, 456789, M_SQRT2), true);
@@ -226,6 +640,38 @@ int main() {
         }
         cout << contact.name << " " << contact.phone_number.country_code << " " << contact.phone_number.number << endl;
     }
+
+    if (!check_sink(book, encodeContainer.content)) {
+        return 1;
+    }
+
+    if (!check_parser()) {
+        return 1;
+    }
+
+    if (!check_wide_closure()) {
+        return 1;
+    }
+
+    if (!check_decoder_reset(book, encodeContainer.content)) {
+        return 1;
+    }
+
+    if (!check_encoder_reuse(book, encodeContainer.content)) {
+        return 1;
+    }
+
+    if (!check_fields(book, encodeContainer.content)) {
+        return 1;
+    }
+
+    if (!check_no_copies()) {
+        return 1;
+    }
+
+    if (!check_binary(book)) {
+        return 1;
+    }
     
 	return 0;
 }
@@ -0,0 +1,224 @@
+//Test of CBOR encoder/decoder
+//Description: checking encoding and decoding with examples from Appendix A of RFC 8949, then decoding of indefinite-length
+//items and malformed data.
+
+#include "Codable.hpp"
+#include "CBOR.hpp"
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+using namespace std;
+
+string from_hex(const string& hex) {
+    string result;
+    for (unsigned long i = 0; i + 1 < hex.length(); i += 2) {
+        result += (char)stoi(hex.substr(i, 2), nullptr, 16);
+    }
+    return result;
+}
+
+string to_hex(const string& data) {
+    const char* digits = "0123456789abcdef";
+    string result;
+    for (unsigned char c : data) {
+        result += digits[c >> 4];
+        result += digits[c & 0xF];
+    }
+    return result;
+}
+
+//Encoding value without key and comparing with expected bytes
+template <typename T>
+bool check_encode(const T& value, const string& hex) {
+    CBOREncodeContainer container = CBOREncoder().container();
+    container.encode(value, CodingKey());
+    if (to_hex(container.content) != hex) {
+        cerr << "[CBOR check]: encoded " << to_hex(container.content) << " instead of " << hex << '\n';
+        return false;
+    }
+    return true;
+}
+
+//Decoding value and comparing with expected one
+template <typename T>
+bool check_decode(const string& hex, const T& reference) {
+    CBORDecoder decoder;
+    CBORDecodeContainer container = decoder.container(from_hex(hex));
+    T value = T();
+    if (!container.decodeTo(value) || !(value == reference)) {
+        cerr << "[CBOR check]: failed to decode " << hex << '\n';
+        return false;
+    }
+    return true;
+}
+
+//Checking that value is encoded to expected bytes and decoded back
+template <typename T>
+bool check_vector(const T& value, const string& hex) {
+    return check_encode(value, hex) && check_decode(hex, value);
+}
+
+bool check_integers() {
+    return check_vector(0, "00") && check_vector(1, "01") && check_vector(10, "0a") && check_vector(23, "17")
+        && check_vector(24, "1818") && check_vector(25, "1819") && check_vector(100, "1864") && check_vector(1000, "1903e8")
+        && check_vector(1000000, "1a000f4240") && check_vector(1000000000000LL, "1b000000e8d4a51000")
+        && check_vector(-1, "20") && check_vector(-10, "29") && check_vector(-100, "3863") && check_vector(-1000, "3903e7")
+        && check_vector(numeric_limits<long long>::min(), "3b7fffffffffffffff");
+}
+
+bool check_floating() {
+    const double infinity = numeric_limits<double>::infinity();
+    if (!(check_vector(0.0, "f90000") && check_vector(-0.0, "f98000") && check_vector(1.0, "f93c00")
+        && check_vector(1.1, "fb3ff199999999999a") && check_vector(1.5, "f93e00") && check_vector(65504.0, "f97bff")
+        && check_vector(100000.0, "fa47c35000") && check_vector(3.4028234663852886e+38, "fa7f7fffff")
+        && check_vector(1.0e+300, "fb7e37e43c8800759c") && check_vector(5.960464477539063e-8, "f90001")
+        && check_vector(0.00006103515625, "f90400") && check_vector(-4.0, "f9c400") && check_vector(-4.1, "fbc010666666666666")
+        && check_vector(infinity, "f97c00") && check_vector(-infinity, "f9fc00") && check_vector(1.5f, "f93e00"))) {
+        return false;
+    }
+    //Longer forms that are not written by encoder
+    if (!(check_decode("fa7f800000", infinity) && check_decode("fb7ff0000000000000", infinity) && check_decode("fa3fc00000", 1.5))) {
+        return false;
+    }
+    //NaN is always written in half precision
+    if (!check_encode(numeric_limits<double>::quiet_NaN(), "f97e00")) {
+        return false;
+    }
+    double nan = 0;
+    CBORDecoder decoder;
+    if (!decoder.container(from_hex("f97e00")).decodeTo(nan) || nan == nan) {
+        cerr << "[CBOR check]: failed to decode NaN\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_simple() {
+    return check_vector(false, "f4") && check_vector(true, "f5") && check_vector(string(""), "60") && check_vector(string("a"), "6161")
+        && check_vector(string("IETF"), "6449455446") && check_vector(string("\"\\"), "62225c")
+        && check_vector(string("\xc3\xbc"), "62c3bc") && check_vector(string("\xe6\xb0\xb4"), "63e6b0b4");
+}
+
+bool check_arrays() {
+    vector<int> numbers;
+    for (int i = 1; i <= 25; i++) {
+        numbers.push_back(i);
+    }
+    const string numbersHex = "0102030405060708090a0b0c0d0e0f101112131415161718181819";
+    return check_vector(vector<int>(), "80") && check_vector(vector<int>({ 1, 2, 3 }), "83010203")
+        && check_vector(numbers, "9819" + numbersHex) && check_decode("9fff", vector<int>())
+        && check_decode("9f" + numbersHex + "ff", numbers)
+        && check_vector(vector<vector<int>>({ { 1 }, { 2, 3 } }), "828101820203")
+        && check_decode("9f81018202039f0405ffff", vector<vector<int>>({ { 1 }, { 2, 3 }, { 4, 5 } }));
+}
+
+class Pair {
+public:
+    int a;
+    vector<int> b;
+
+    bool operator ==(const Pair& pair) const {
+        return a == pair.a && b == pair.b;
+    }
+
+    CODABLE_FIELDS(Pair, a, b)
+};
+
+class Letters {
+public:
+    string a, b, c, d, e;
+
+    bool operator ==(const Letters& letters) const {
+        return a == letters.a && b == letters.b && c == letters.c && d == letters.d && e == letters.e;
+    }
+
+    CODABLE_FIELDS(Letters, a, b, c, d, e)
+};
+
+class FunAmount {
+public:
+    bool Fun;
+    int Amt;
+
+    CODABLE_FIELDS(FunAmount, Fun, Amt)
+};
+
+bool check_maps() {
+    Pair pair;
+    pair.a = 1;
+    pair.b = { 2, 3 };
+    Letters letters;
+    letters.a = "A";
+    letters.b = "B";
+    letters.c = "C";
+    letters.d = "D";
+    letters.e = "E";
+    Letters partial;
+    partial.c = "C";
+    partial.d = "D";
+    partial.e = "E";
+    //Closures are written as indefinite-length maps
+    FunAmount fun;
+    fun.Fun = true;
+    fun.Amt = -2;
+    return check_decode("a26161016162820203", pair) && check_decode("bf61610161629f0203ffff", pair)
+        && check_decode("a56161614161626142616361436164614461656145", letters)
+        //Fields in other order and unknown fields
+        && check_decode("a4616561456178f66164614461636143", partial)
+        && check_encode(fun, "bf6346756ef563416d7421ff")
+        && check_encode(pair, "bf6161016162820203ff");
+}
+
+bool check_streaming() {
+    return check_decode("7f657374726561646d696e67ff", string("streaming"))
+        && check_decode("5f42010243030405ff", string("\1\2\3\4\5"))
+        //Tag is skipped (epoch-based date/time)
+        && check_decode("c11a514b67b0", 1363896240);
+}
+
+//Malformed data must be rejected without reading outside of buffer
+bool check_malformed() {
+    const char* cases[] = { "", "18", "1b0000", "62", "7f6161", "7f01ff", "9b00000000ffffffff", "1c", "ff", "bf6161", "a1616101" };
+    for (const char* hex : cases) {
+        CBORDecoder decoder;
+        CBORDecodeContainer container = decoder.container(from_hex(hex));
+        int number = 7;
+        string text = "kept";
+        vector<int> numbers = { 7 };
+        Pair pair;
+        pair.a = 7;
+        container.decodeTo(number);
+        container.decodeTo(text);
+        container.decodeTo(numbers);
+        container.decodeTo(pair);
+        if (number != 7) {
+            cerr << "[CBOR check]: malformed " << hex << " decoded as integer\n";
+            return false;
+        }
+        if (text != "kept") {
+            cerr << "[CBOR check]: malformed " << hex << " decoded as string\n";
+            return false;
+        }
+    }
+    //Types that don't match
+    CBORDecoder decoder;
+    int number = 7;
+    if (decoder.container(from_hex("6161")).decodeTo(number) || number != 7) {
+        cerr << "[CBOR check]: string decoded as integer\n";
+        return false;
+    }
+    if (decoder.container(from_hex("1b8000000000000000")).decodeTo(number) || number != 7) {
+        cerr << "[CBOR check]: too big integer decoded\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check_integers() || !check_floating() || !check_simple() || !check_arrays() || !check_maps()
+        || !check_streaming() || !check_malformed()) {
+        return 1;
+    }
+    return 0;
+}
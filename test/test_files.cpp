@@ -0,0 +1,180 @@
+//Test of file input and output
+//Description: encoding documents to file descriptor through small buffer, then decoding them from mapped files,
+//sizes of pieces that are written to sink.
+
+#include "CBOR.hpp"
+#include "Codable.hpp"
+#include "FileIO.hpp"
+#include "JSON.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Entry {
+public:
+    int id;
+    string title;
+    vector<double> values;
+
+    bool operator ==(const Entry& entry) const {
+        return id == entry.id && title == entry.title && values == entry.values;
+    }
+
+    CODABLE_FIELDS(Entry, id, title, values)
+};
+
+class Catalog {
+public:
+    string name;
+    vector<Entry> entries;
+
+    CODABLE_FIELDS(Catalog, name, entries)
+};
+
+const char* path = "test_files.json";
+const char* secondPath = "test_files_second.json";
+
+//Writing text to file with stdio
+void write_file(const string& text, const char* path = ::path) {
+    FILE* file = fopen(path, "wb");
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+}
+
+bool check_sink() {
+    Catalog catalog;
+    catalog.name = "catalog";
+    for (int i = 0; i < 20000; i++) {
+        Entry entry;
+        entry.id = i;
+        entry.title = "entry " + to_string(i);
+        entry.values = vector<double>(i % 5, i * 1.5);
+        catalog.entries.push_back(entry);
+    }
+    JSONEncodeContainer serial = JSONEncoder().container();
+    serial.encode(catalog);
+
+    //Buffer is smaller than pieces flushed by container, so they are written directly too
+    for (unsigned long capacity : { 100ul, 1ul << 20 }) {
+        FILE* file = fopen(path, "wb");
+        {
+            CodableFileSink sink(fileno(file), capacity);
+            JSONEncodeContainer container = JSONEncoder().container(&sink);
+            container.encode(catalog);
+            if (!sink.flush()) {
+                cerr << "[Files check]: writing to file failed\n";
+                return false;
+            }
+        }
+        fclose(file);
+
+        CodableMappedFile mapped;
+        if (!mapped.open(path) || string(mapped.data, mapped.length) != serial.content) {
+            cerr << "[Files check]: file written by sink with buffer of " << capacity << " bytes differs from encoded text\n";
+            return false;
+        }
+        JSONDecoder decoder;
+        Catalog decoded;
+        decoder.containerFromFile(path).decodeTo(decoded);
+        if (decoded.name != catalog.name || decoded.entries != catalog.entries) {
+            cerr << "[Files check]: catalog is decoded from mapped file incorrectly\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+//Sink that keeps size of the largest piece
+class PieceSink: public CoderSink {
+public:
+    string text;
+    unsigned long largest = 0;
+
+    void write(const char* data, unsigned long length) {
+        text.append(data, length);
+        largest = max(largest, length);
+    }
+};
+
+class Arrays {
+public:
+    vector<int> numbers;
+    vector<string> strings;
+
+    CODABLE_FIELDS(Arrays, numbers, strings)
+};
+
+//Big arrays must be written to sink by pieces, not as one piece after they are finished
+bool check_pieces() {
+    const unsigned long limit = 2 << 16;
+    Arrays arrays;
+    arrays.numbers.resize(2000000);
+    arrays.strings.resize(200000);
+    for (unsigned long i = 0; i < arrays.numbers.size(); i++) {
+        arrays.numbers[i] = (int)(i * 7919);
+    }
+    for (unsigned long i = 0; i < arrays.strings.size(); i++) {
+        arrays.strings[i] = "string " + to_string(i);
+    }
+
+    PieceSink sink;
+    JSONEncodeContainer container = JSONEncoder().container(&sink);
+    container.encode(arrays);
+    JSONEncodeContainer serial = JSONEncoder().container();
+    serial.encode(arrays);
+    if (sink.text != serial.content || sink.largest > limit) {
+        cerr << "[Files check]: JSON arrays are written to sink by pieces of up to " << sink.largest << " bytes\n";
+        return false;
+    }
+
+    PieceSink binarySink;
+    CBOREncodeContainer binary = CBOREncoder().container(&binarySink);
+    binary.encode(arrays);
+    if (binarySink.largest > limit) {
+        cerr << "[Files check]: CBOR arrays are written to sink by pieces of up to " << binarySink.largest << " bytes\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_mapped() {
+    JSONDecoder decoder;
+    vector<int> numbers;
+    if (decoder.containerFromFile("missing_file.json").decodeTo(numbers, "numbers")) {
+        cerr << "[Files check]: missing file is decoded\n";
+        return false;
+    }
+    write_file("");
+    if (decoder.containerFromFile(path).decodeTo(numbers, "numbers")) {
+        cerr << "[Files check]: empty file is decoded\n";
+        return false;
+    }
+    decoder.reset();
+
+    //Document ends exactly at the end of page, so nothing after it is mapped
+    string text = "{\"numbers\": [1, 2, 3]";
+    text += string(4096 - text.size() - 1, ' ') + "}";
+    write_file(text);
+    JSONDecodeContainer first = decoder.containerFromFile(path);
+    write_file("{\"numbers\": [4, 5]}", secondPath);
+    //The first file stays mapped while the second one is decoded
+    JSONDecodeContainer second = decoder.containerFromFile(secondPath);
+    vector<int> firstNumbers, secondNumbers;
+    if (!first.decodeTo(firstNumbers, "numbers") || firstNumbers != vector<int>({ 1, 2, 3 }) ||
+        !second.decodeTo(secondNumbers, "numbers") || secondNumbers != vector<int>({ 4, 5 })) {
+        cerr << "[Files check]: mapped files are decoded incorrectly\n";
+        return false;
+    }
+    decoder.reset();
+    return true;
+}
+
+int main() {
+    bool passed = check_sink() && check_pieces() && check_mapped();
+    remove(path);
+    remove(secondPath);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+//Test of formats of JSON text
+//Description: encoding in standard, compact and pretty formats, reformatting of text to the same formats,
+//decoding of formatted text and parallel encoding with format.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONFormat.hpp"
+#include "JSONParallel.hpp"
+#include "ThreadPool.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Point {
+public:
+    int x;
+    int y;
+
+    bool operator ==(const Point& point) const {
+        return x == point.x && y == point.y;
+    }
+
+    CODABLE_FIELDS(Point, x, y)
+};
+
+class Shape {
+public:
+    string name;
+    vector<Point> points;
+    vector<int> tags;
+
+    bool operator ==(const Shape& shape) const {
+        return name == shape.name && points == shape.points && tags == shape.tags;
+    }
+
+    CODABLE_FIELDS(Shape, name, points, tags)
+};
+
+Shape make_shape() {
+    Shape shape;
+    shape.name = "tri angle, {1}: [2]";
+    shape.points = { { 0, 0 }, { 3, -1 } };
+    return shape;
+}
+
+string encode(const Shape& shape, const JSONFormat& format) {
+    JSONEncodeContainer container = JSONEncoder(format).container();
+    container.encode(shape);
+    return container.content;
+}
+
+bool check_encoding() {
+    Shape shape = make_shape();
+    const char* expected[] = {
+        "{\"name\": \"tri angle, {1}: [2]\",\"points\": [{\"x\": 0,\"y\": 0},{\"x\": 3,\"y\": -1}],\"tags\": []}",
+        "{\"name\":\"tri angle, {1}: [2]\",\"points\":[{\"x\":0,\"y\":0},{\"x\":3,\"y\":-1}],\"tags\":[]}",
+        "{\n  \"name\": \"tri angle, {1}: [2]\",\n  \"points\": [\n    {\n      \"x\": 0,\n      \"y\": 0\n    },\n"
+        "    {\n      \"x\": 3,\n      \"y\": -1\n    }\n  ],\n  \"tags\": []\n}"
+    };
+    JSONFormat formats[] = { JSONFormat(), JSONFormat(JSONFormatStyle::compact), JSONFormat(JSONFormatStyle::pretty, 2) };
+    for (int i = 0; i < 3; i++) {
+        string text = encode(shape, formats[i]);
+        if (text != expected[i]) {
+            cerr << "[Encoding check]: wrong text of format " << i << ":\n" << text << '\n';
+            return false;
+        }
+        JSONDecoder decoder;
+        if (!(decoder.container(text).decode(Shape()) == shape)) {
+            cerr << "[Encoding check]: text of format " << i << " is decoded incorrectly\n";
+            return false;
+        }
+        //Reformatting of text of every format gives text of encoder
+        for (int j = 0; j < 3; j++) {
+            string reformatted;
+            if (!jsonReformat(text.data(), text.length(), formats[j], reformatted) || reformatted != expected[j]) {
+                cerr << "[Encoding check]: wrong reformatting from format " << i << " to " << j << ":\n" << reformatted << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool check_reformat() {
+    const char* text = " \r\n{ \"a\\\" b\" :\t[ 1 , true,null, \"x y\" , { } , [\n] ] ,\"c\":-2.5e3 }\n";
+    string minified;
+    if (!jsonMinify(text, strlen(text), minified) || minified != "{\"a\\\" b\":[1,true,null,\"x y\",{},[]],\"c\":-2.5e3}") {
+        cerr << "[Reformat check]: wrong minified text: " << minified << '\n';
+        return false;
+    }
+    const char* broken[] = { "{\"a\": [1}", "[1, 2", "{\"a\": \"b", "]" };
+    for (const char* piece : broken) {
+        string output;
+        if (jsonMinify(piece, strlen(piece), output)) {
+            cerr << "[Reformat check]: broken text isn't reported: " << piece << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_parallel() {
+    vector<Shape> shapes;
+    for (int i = 0; i < 300; i++) {
+        Shape shape = make_shape();
+        shape.tags = vector<int>(i % 3, i);
+        shapes.push_back(shape);
+    }
+    CodableThreadPool pool(4);
+    JSONParallelEncoder parallel(&pool);
+    for (JSONFormat format : { JSONFormat(JSONFormatStyle::compact), JSONFormat(JSONFormatStyle::pretty, 3) }) {
+        JSONEncoder encoder(format);
+        JSONEncodeContainer serial = encoder.container(), encoded = encoder.container();
+        serial.encode(shapes);
+        parallel.encode(encoded, shapes);
+        if (serial.content != encoded.content) {
+            cerr << "[Parallel check]: parallel text differs from serial one\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    if (!check_encoding() || !check_reformat() || !check_parallel()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+//Test of lazy decoding
+//Description: decoding documents in lazy mode fully and partially, comparing results and memory with eager decoding.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONParallel.hpp"
+#include "JSONStream.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Point {
+public:
+    double x, y;
+    vector<int> tags;
+
+    bool operator ==(const Point& point) const {
+        return x == point.x && y == point.y && tags == point.tags;
+    }
+
+    CODABLE_FIELDS(Point, x, y, tags)
+};
+
+class Shape {
+public:
+    string name;
+    Point center;
+    vector<Point> points;
+    vector<vector<int>> grid;
+
+    bool operator ==(const Shape& shape) const {
+        return name == shape.name && center == shape.center && points == shape.points && grid == shape.grid;
+    }
+
+    CODABLE_FIELDS(Shape, name, center, points, grid)
+};
+
+class Scene {
+public:
+    string title;
+    vector<Shape> shapes;
+    int version;
+
+    CODABLE_FIELDS(Scene, title, shapes, version)
+};
+
+Scene make_scene(int count) {
+    Scene scene;
+    scene.title = "scene";
+    scene.version = 3;
+    for (int i = 0; i < count; i++) {
+        Shape shape;
+        shape.name = "shape " + to_string(i);
+        shape.center = { i * 0.5, -i * 0.25, { i, i + 1 } };
+        for (int j = 0; j < i % 5; j++) {
+            shape.points.push_back({ (double)j, (double)i, vector<int>(j, j) });
+        }
+        shape.grid = { { i, 1 }, {}, { i % 7 } };
+        scene.shapes.push_back(shape);
+    }
+    return scene;
+}
+
+bool check_full() {
+    Scene scene = make_scene(2000);
+    JSONEncodeContainer encoded = JSONEncoder().container();
+    encoded.encode(scene);
+
+    JSONDecoder decoder;
+    decoder.setLazy(true);
+    Scene decoded;
+    decoder.container(encoded.content).decodeTo(decoded);
+    if (decoded.title != scene.title || decoded.version != scene.version || decoded.shapes != scene.shapes) {
+        cerr << "[Lazy check]: scene is decoded incorrectly\n";
+        return false;
+    }
+    //Elements of lazy array are decoded by threads with their own parsers
+    CodableThreadPool pool(4);
+    JSONParallelDecoder parallel(&pool);
+    decoder.reset();
+    for (int depth = 0; depth < 2; depth++) {
+        JSONDecodeContainer container = decoder.container(encoded.content);
+        if (depth == 1) {
+            //Array is expanded, its elements are not
+            container["shapes"]->expand();
+        }
+        vector<Shape> shapes;
+        if (!parallel.decodeTo(container, shapes, "shapes") || shapes != scene.shapes) {
+            cerr << "[Lazy check]: shapes are decoded by threads incorrectly\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_partial() {
+    Scene scene = make_scene(5000);
+    JSONEncodeContainer encoded = JSONEncoder().container();
+    encoded.encode(scene);
+
+    Arena eagerArena, lazyArena;
+    JSONDecoder eager(&eagerArena), lazy(&lazyArena);
+    lazy.setLazy(true);
+    JSONDecodeContainer eagerContainer = eager.container(encoded.content);
+    JSONDecodeContainer container = lazy.container(encoded.content);
+    //Only the highest closure and the accessed shape are expanded
+    JSONDecodeContainer* shapes = container["shapes"];
+    if (shapes == NULL || shapes->expander == NULL || shapes->childrenCount != 0) {
+        cerr << "[Lazy check]: array isn't kept as text\n";
+        return false;
+    }
+    unsigned long count = 0;
+    Shape last;
+    for (const Shape& shape : container.elements<Shape>("shapes")) {
+        count++;
+        last = shape;
+    }
+    JSONDecodeContainer* grid = container["shapes"];
+    grid->expand();
+    grid = (*grid->children[1234])["grid"];
+    //Children are read directly, so they are built first
+    grid->expand();
+    vector<int> row;
+    if (count != scene.shapes.size() || !(last == scene.shapes.back()) || container.decode(0, "version") != 3 ||
+        !grid->children[0]->decodeTo(row) || row != scene.shapes[1234].grid[0]) {
+        cerr << "[Lazy check]: fields are decoded incorrectly\n";
+        return false;
+    }
+    if (lazyArena.capacity() * 4 > eagerArena.capacity()) {
+        cerr << "[Lazy check]: lazy decoding uses " << lazyArena.capacity() << " bytes, eager one uses " << eagerArena.capacity() << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool check_malformed() {
+    const char* texts[] = { "{\"a\": {\"b\": [1, 2", "{\"a\": {\"b\": }}", "[[[]]]", "{\"a\": {}}", "{\"a\": []}" };
+    for (const char* text : texts) {
+        JSONDecoder decoder;
+        decoder.setLazy(true);
+        JSONDecodeContainer container = decoder.container(text);
+        vector<int> numbers;
+        //Nothing is checked here except that access to broken and empty containers is safe
+        container.decodeTo(numbers, "a");
+        JSONDecodeContainer* a = container["a"];
+        if (a != NULL) {
+            a->decodeTo(numbers, "b");
+        }
+        if (container.childrenCount > 0) {
+            container.children[0]->decodeTo(numbers);
+        }
+    }
+    return true;
+}
+
+int main() {
+    if (!check_full() || !check_partial() || !check_malformed()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+//Test of newline-delimited JSON
+//Description: encoding records to lines (with any format of container) and decoding them back by one and by several threads.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONLines.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+class LogRecord {
+public:
+    long long time;
+    string level;
+    string message;
+    vector<int> codes;
+
+    bool operator ==(const LogRecord& record) const {
+        return time == record.time && level == record.level && message == record.message && codes == record.codes;
+    }
+
+    CODABLE_FIELDS(LogRecord, time, level, message, codes)
+};
+
+vector<LogRecord> make_records(int count) {
+    vector<LogRecord> records;
+    for (int i = 0; i < count; i++) {
+        LogRecord record;
+        record.time = 1700000000000LL + i;
+        record.level = i % 10 ? "info" : "error";
+        //Escaped newline stays inside of record
+        record.message = "request " + to_string(i) + (i % 3 ? " done" : " failed:\nretry");
+        record.codes = vector<int>(i % 4, 200 + i % 7);
+        records.push_back(record);
+    }
+    return records;
+}
+
+bool check_lines(const vector<LogRecord>& records, const string& text) {
+    for (unsigned threads : { 1u, 2u, 4u }) {
+        JSONLinesDecoder decoder(threads);
+        vector<LogRecord> decoded;
+        if (decoder.decode(text.data(), text.length(), decoded) != records.size() || decoded != records) {
+            cerr << "[Lines check]: records are decoded incorrectly by " << threads << " threads\n";
+            return false;
+        }
+    }
+    JSONLinesDecoder decoder;
+    vector<LogRecord> decoded;
+    unsigned long count = decoder.decodeEach<LogRecord>(text.data(), text.length(), [&](LogRecord& record) {
+        decoded.push_back(record);
+    });
+    if (count != records.size() || decoded != records) {
+        cerr << "[Lines check]: records are decoded incorrectly one by one\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_records() {
+    vector<LogRecord> records = make_records(1000);
+    JSONEncodeContainer container = JSONEncoder().container();
+    for (const LogRecord& record : records) {
+        container.encodeLine(record);
+    }
+    const string& text = container.content;
+    unsigned long lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    if (lines != records.size() || text.back() != '\n') {
+        cerr << "[Lines check]: records are not written one per line\n";
+        return false;
+    }
+    if (!check_lines(records, text)) {
+        return false;
+    }
+    //Containers with pretty format write records on one line too
+    JSONEncodeContainer pretty = JSONEncoder(JSONFormat(JSONFormatStyle::pretty)).container();
+    for (const LogRecord& record : records) {
+        pretty.encodeLine(record);
+    }
+    if (pretty.content != text) {
+        cerr << "[Lines check]: records of container with pretty format are not written one per line\n";
+        return false;
+    }
+    //CRLF line endings, empty lines and missing newline at the end
+    string edited = "\r\n" + text.substr(0, text.length() - 1);
+    string crlf;
+    for (char c : edited) {
+        crlf += c == '\n' ? string("\r\n\n") : string(1, c);
+    }
+    return check_lines(records, crlf);
+}
+
+//Lines that aren't closures are written like values of documents
+bool check_values() {
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encodeLine(5);
+    container.encodeLine(string("text"));
+    container.encodeLine(vector<int>({ 1, 2 }));
+    container.encodeLine(map<string, int>({ { "a", 1 } }));
+    container.encodeLine(make_records(1)[0]);
+    string expected = "5\n\"text\"\n[1,2]\n{\"a\": 1}\n";
+    if (container.content.compare(0, expected.length(), expected) != 0 || container.content[expected.length()] != '{') {
+        cerr << "[Lines check]: values are written to lines incorrectly: " << container.content << '\n';
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check_records() || !check_values()) {
+        return 1;
+    }
+    return 0;
+}
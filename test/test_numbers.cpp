@@ -0,0 +1,130 @@
+//Test of locale-independent number conversions
+//Description: checking exact round trip of random floating point numbers, fixed formatting samples and parsing edge cases.
+
+#define _USE_MATH_DEFINES
+
+#include "JSONNumber.hpp"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <random>
+#include <stdint.h>
+#include <string>
+using namespace std;
+
+//Every finite double must be written and parsed back without changes
+bool check_double_round_trip() {
+    mt19937_64 random(2024);
+    char buffer[JSONNumberBufferSize];
+    for (int i = 0; i < 200000; i++) {
+        uint64_t bits = random();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) {
+            continue;
+        }
+        int length = jsonWriteDouble(value, buffer);
+        double parsed;
+        if (!jsonParseDouble(buffer, length, parsed) || memcmp(&parsed, &value, sizeof(value)) != 0) {
+            cerr << "[Double check]: " << string(buffer, length) << " is not parsed back\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_float_round_trip() {
+    mt19937 random(2024);
+    char buffer[JSONNumberBufferSize];
+    for (int i = 0; i < 200000; i++) {
+        uint32_t bits = random();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) {
+            continue;
+        }
+        int length = jsonWriteFloat(value, buffer);
+        float parsed;
+        if (!jsonParseFloat(buffer, length, parsed) || memcmp(&parsed, &value, sizeof(value)) != 0) {
+            cerr << "[Float check]: " << string(buffer, length) << " is not parsed back\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_formatting() {
+    const double values[] = { 0.1, 3, -0.0, 1e21, 1e-7, 0.0001, 123456.789, 5e-324, 1.7976931348623157e308, M_PI, NAN };
+    const char* expected[] = { "0.1", "3", "-0", "1e+21", "1e-07", "0.0001", "123456.789", "5e-324", "1.7976931348623157e+308", "3.141592653589793", "null" };
+    char buffer[JSONNumberBufferSize];
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        string text(buffer, jsonWriteDouble(values[i], buffer));
+        if (text != expected[i]) {
+            cerr << "[Formatting check]: " << text << " instead of " << expected[i] << '\n';
+            return false;
+        }
+    }
+    string text(buffer, jsonWriteFloat(1.41421356f, buffer));
+    if (text != "1.4142135") {
+        cerr << "[Formatting check]: " << text << " instead of 1.4142135\n";
+        return false;
+    }
+    text.assign(buffer, jsonWriteInteger(-9223372036854775807LL - 1, buffer));
+    if (text != "-9223372036854775808") {
+        cerr << "[Formatting check]: " << text << " instead of minimal long long\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_parsing() {
+    //Numbers with many digits near the middle between two doubles are rounded exactly (ties to even)
+    const char* texts[] = { "0.30000000000000004", "2.2250738585072011e-308", "1e400", "-1e-400", "123456789012345678901234567890", "1E+2",
+        "9007199254740993.00000000000000000001", "9007199254740992.99999999999999999999",
+        "1.00000000000000011102230246251565404236316680908203125", "1.00000000000000011102230246251565404236316680908203126" };
+    const double values[] = { 0.30000000000000004, 2.2250738585072011e-308, INFINITY, -0.0, 123456789012345678901234567890.0, 100,
+        9007199254740994.0, 9007199254740992.0, 1.0, 1.0000000000000002 };
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+        double parsed;
+        if (!jsonParseDouble(texts[i], strlen(texts[i]), parsed) || memcmp(&parsed, &values[i], sizeof(parsed)) != 0) {
+            cerr << "[Parsing check]: " << texts[i] << " is parsed as " << parsed << '\n';
+            return false;
+        }
+    }
+    const char* wrong[] = { "", "-", "abc", "1e", "1.5x", "\"1\"" };
+    for (size_t i = 0; i < sizeof(wrong) / sizeof(wrong[0]); i++) {
+        double parsed;
+        if (jsonParseDouble(wrong[i], strlen(wrong[i]), parsed)) {
+            cerr << "[Parsing check]: " << wrong[i] << " is parsed as number\n";
+            return false;
+        }
+    }
+    long long integer;
+    if (!jsonParseInteger("-42.9", 5, integer) || integer != -42) {
+        cerr << "[Parsing check]: fraction of integer is not truncated\n";
+        return false;
+    }
+    if (jsonParseInteger("9223372036854775808", 19, integer)) {
+        cerr << "[Parsing check]: overflow of integer is not detected\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    //Conversions must not depend on global locale, so try to set one with comma as decimal separator
+    const char* locales[] = { "de_DE.UTF-8", "ru_RU.UTF-8", "fr_FR.UTF-8" };
+    for (int i = 0; i < 3; i++) {
+        try {
+            locale::global(locale(locales[i]));
+            break;
+        }
+        catch (...) {}
+    }
+
+    if (!check_double_round_trip() || !check_float_round_trip() || !check_formatting() || !check_parsing()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+//Test of parallel decoding
+//Description: checking thread pool on uneven work, then comparing parallel decoding of arrays with serial one.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONParallel.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+bool check_pool() {
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        CodableThreadPool pool(threads);
+        for (unsigned long count : { 0ul, 1ul, 7ul, 1000ul, 100000ul }) {
+            vector<int> visits(count, 0);
+            atomic<unsigned long> sum(0);
+            pool.parallelFor(count, 13, [&](unsigned worker, unsigned long begin, unsigned long end) {
+                unsigned long local = 0;
+                for (unsigned long i = begin; i < end; i++) {
+                    visits[i]++;
+                    //Uneven work, so chunks are stolen
+                    for (unsigned long j = 0; j < i % 100; j++) {
+                        local += j;
+                    }
+                    local += i;
+                }
+                sum += local;
+                if (worker >= pool.size()) {
+                    visits[begin] = -1000;
+                }
+            });
+            unsigned long reference = 0;
+            for (unsigned long i = 0; i < count; i++) {
+                for (unsigned long j = 0; j < i % 100; j++) {
+                    reference += j;
+                }
+                reference += i;
+            }
+            if (sum != reference || vector<int>(count, 1) != visits) {
+                cerr << "[Parallel check]: pool of " << threads << " threads processed range of " << count << " incorrectly\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+class Item {
+public:
+    int id;
+    string name;
+    vector<double> prices;
+
+    bool operator ==(const Item& item) const {
+        return id == item.id && name == item.name && prices == item.prices;
+    }
+
+    CODABLE_FIELDS(Item, id, name, prices)
+};
+
+//Class with many fields, its key index is built in decoding threads
+class WideItem {
+public:
+    int f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17;
+
+    CODABLE_FIELDS(WideItem, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17)
+};
+
+bool check_items() {
+    vector<Item> items;
+    for (int i = 0; i < 5000; i++) {
+        Item item;
+        item.id = i;
+        item.name = "item " + to_string(i);
+        item.prices = vector<double>(i % 6, i * 0.25);
+        items.push_back(item);
+    }
+    JSONEncodeContainer encoded = JSONEncoder().container();
+    encoded.encode(items);
+    //Document with array that is found by key
+    const string text = "{\"items\": " + encoded.content + "}";
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        CodableThreadPool pool(threads);
+        JSONParallelDecoder parallel(&pool);
+        for (unsigned long depth : { 0ul, 1ul }) {
+            JSONDecoder decoder;
+            decoder.setMaxDepth(depth);
+            JSONDecodeContainer container = decoder.container(text);
+            vector<Item> decoded;
+            if (!parallel.decodeTo(container, decoded, "items") || decoded != items) {
+                cerr << "[Parallel check]: items are decoded incorrectly by " << threads << " threads with depth " << depth << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool check_wide_items() {
+    //Fields are written in reverse order
+    string text = "[";
+    for (int i = 0; i < 2000; i++) {
+        text += i ? ",{" : "{";
+        for (int field = 17; field >= 0; field--) {
+            text += "\"f" + to_string(field) + "\": " + to_string(i * 100 + field) + (field ? "," : "}");
+        }
+    }
+    text += "]";
+    CodableThreadPool pool(4);
+    JSONParallelDecoder parallel(&pool);
+    JSONDecoder decoder;
+    JSONDecodeContainer container = decoder.container(text);
+    vector<WideItem> decoded;
+    parallel.decodeTo(container, decoded);
+    for (int i = 0; i < 2000; i++) {
+        if (decoded[i].f0 != i * 100 || decoded[i].f9 != i * 100 + 9 || decoded[i].f17 != i * 100 + 17) {
+            cerr << "[Parallel check]: wide items are decoded incorrectly\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+//Sink that collects written text
+class StringSink: public CoderSink {
+public:
+    string text;
+
+    void write(const char* data, unsigned long length) override {
+        text.append(data, length);
+    }
+};
+
+bool check_encoding() {
+    for (unsigned long count : { 0ul, 1ul, 17ul, 5000ul }) {
+        vector<Item> items;
+        for (unsigned long i = 0; i < count; i++) {
+            Item item;
+            item.id = (int)i;
+            item.name = "item " + to_string(i);
+            item.prices = vector<double>(i % 4, i * 0.5);
+            items.push_back(item);
+        }
+        JSONEncodeContainer serial = JSONEncoder().container();
+        serial.encode(items);
+        JSONEncodeContainer serialKeyed = JSONEncoder().container();
+        serialKeyed.encode(1, "first");
+        serialKeyed.encode(items, "items");
+
+        for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+            CodableThreadPool pool(threads);
+            JSONParallelEncoder parallel(&pool);
+            JSONEncodeContainer container = JSONEncoder().container();
+            //The second document checks that reused pieces are cleared
+            parallel.encode(container, items);
+            parallel.encode(container, items);
+            JSONEncodeContainer keyed = JSONEncoder().container();
+            keyed.encode(1, "first");
+            parallel.encode(keyed, items, "items");
+            StringSink sink;
+            JSONEncodeContainer sinkContainer = JSONEncoder().container(&sink);
+            parallel.encode(sinkContainer, items);
+            if (container.content != serial.content || keyed.content != serialKeyed.content || sink.text != serial.content) {
+                cerr << "[Parallel check]: " << count << " items are encoded by " << threads << " threads to different text\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    if (!check_pool() || !check_items() || !check_wide_items() || !check_encoding()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+//Test of decoding with plans
+//Description: decoding documents directly to objects with decode plans and comparing results with generic decoder.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONPlan.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+//Class with Codable protocol, it is decoded by generic decoder inside of plans
+class Signal: public Codable {
+public:
+    int level = 0;
+    string source;
+
+    void encode(CoderContainer* container) {
+        JSONEncodeContainer* jsonContainer = dynamic_cast<JSONEncodeContainer*>(container);
+        jsonContainer->encode(level, "level");
+        jsonContainer->encode(source, "source");
+    }
+
+    void decode(CoderContainer* container) {
+        JSONDecodeContainer* jsonContainer = dynamic_cast<JSONDecodeContainer*>(container);
+        jsonContainer->decodeTo(level, "level");
+        jsonContainer->decodeTo(source, "source");
+    }
+
+    bool operator ==(const Signal& signal) const {
+        return level == signal.level && source == signal.source;
+    }
+};
+
+class Phone {
+public:
+    int country = 0;
+    long long number = 0;
+    float weight = 0;
+    Signal signal;
+
+    bool operator ==(const Phone& phone) const {
+        return country == phone.country && number == phone.number && weight == phone.weight && signal == phone.signal;
+    }
+
+    CODABLE_FIELDS(Phone, country, number, weight, signal)
+};
+
+class Person {
+public:
+    string name;
+    bool active = false;
+    double score = 0;
+    Phone phone;
+    vector<Phone> phones;
+    vector<vector<int>> matrix;
+    vector<string> tags;
+
+    bool operator ==(const Person& person) const {
+        return name == person.name && active == person.active && score == person.score && phone == person.phone &&
+            phones == person.phones && matrix == person.matrix && tags == person.tags;
+    }
+
+    CODABLE_FIELDS(Person, name, active, score, phone, phones, matrix, tags)
+};
+
+//Decoding text with plan and with generic decoder to copies of the same initial value
+bool check_same(const string& text, const Person& initial, bool expectValid = true) {
+    JSONPlanDecoder planDecoder;
+    Person planned = initial, generic = initial;
+    bool valid = planDecoder.decode(text, planned);
+    JSONDecoder decoder;
+    decoder.container(text).decodeTo(generic);
+    if (!(planned == generic) || valid != expectValid) {
+        cerr << "[Plan check]: document is decoded differently from generic decoder: " << text << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool check_documents() {
+    Person person;
+    person.name = "Ann";
+    person.active = true;
+    person.score = 12.75;
+    person.phone.country = 7;
+    person.phone.number = 9001234567LL;
+    person.phone.weight = 0.5f;
+    person.phone.signal.level = 3;
+    person.phone.signal.source = "cell";
+    for (int i = 0; i < 50; i++) {
+        Phone phone = person.phone;
+        phone.country = i;
+        phone.signal.level = i * 2;
+        person.phones.push_back(phone);
+        person.matrix.push_back(vector<int>(i % 4, i));
+    }
+    person.tags = { "a", "", "c d" };
+    JSONEncodeContainer encoded = JSONEncoder().container();
+    encoded.encode(person);
+
+    JSONPlanDecoder decoder;
+    Person decoded;
+    if (!decoder.decode(encoded.content, decoded) || !(decoded == person)) {
+        cerr << "[Plan check]: encoded person is decoded incorrectly\n";
+        return false;
+    }
+    //Decoder is reused, vectors are replaced instead of appended
+    if (!decoder.decode(encoded.content, decoded) || !(decoded == person)) {
+        cerr << "[Plan check]: person is decoded incorrectly by reused decoder\n";
+        return false;
+    }
+
+    Person initial;
+    initial.name = "initial";
+    initial.tags = { "kept" };
+    initial.score = -1;
+    return check_same(encoded.content, initial) &&
+        //Reordered, unknown and missing keys
+        check_same("{\"tags\": [\"x\"], \"unknown\": {\"a\": [1, {\"b\": 2}]}, \"name\": \"Bob\", \"extra\": [[]], \"phone\": {\"number\": 5, \"country\": 1}}", initial) &&
+        //Values of other types keep fields
+        check_same("{\"name\": {\"a\": 1}, \"score\": \"text\", \"phone\": [1, 2], \"tags\": null, \"matrix\": 5, \"active\": true}", initial) &&
+        //Empty containers and whitespaces
+        check_same(" {\n\"phones\" : [ ] ,\t\"matrix\": [[], [ ], [1 , 2]], \"phone\": { }, \"tags\": []\n} ", initial) &&
+        check_same("{}", initial) &&
+        check_same("", initial) &&
+        check_same("[1, 2]", initial);
+}
+
+bool check_malformed() {
+    const char* texts[] = { "{\"name\": \"a\", \"phones\": [{\"country\": 1}, {\"country\": ", "{\"name\" \"a\"}", "{\"phones\": [1 {}]}",
+        "{\"matrix\": [[1, 2]", "{,}", "{\"phone\": {\"signal\": {\"level\": 1", "}}]]", "{\"name\": 1 2 3 : 4}" };
+    for (const char* text : texts) {
+        JSONPlanDecoder decoder;
+        Person person;
+        if (decoder.decode(text, strlen(text), person)) {
+            cerr << "[Plan check]: malformed document is decoded as valid one: " << text << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    if (!check_documents() || !check_malformed()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+//Test of statistics of encoders and decoders
+//Description: checking counters after encoding and decoding of known document, they are zeros without CODABLE_ENABLE_STATS.
+//Counters of documents that are encoded or decoded by several threads must be exact too.
+
+#include "Codable.hpp"
+#include "CodableStats.hpp"
+#include "JSON.hpp"
+#include "JSONParallel.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Sample {
+public:
+    int id;
+    double ratio;
+    string name;
+    vector<long long> values;
+
+    CODABLE_FIELDS(Sample, id, ratio, name, values)
+};
+
+bool check_zeros(const CodableStats& stats) {
+    return stats.bytesScanned == 0 && stats.nodesCreated == 0 && stats.allocations == 0 && stats.keyLookups == 0 &&
+        stats.keyProbes == 0 && stats.numbersParsed == 0 && stats.numbersWritten == 0 && stats.bytesWritten == 0 &&
+        stats.tokenizeTime == 0 && stats.treeBuildTime == 0 && stats.fieldDecodeTime == 0 && stats.contentTime == 0;
+}
+
+bool check_stats() {
+    vector<Sample> samples;
+    for (int i = 0; i < 100; i++) {
+        samples.push_back({ i, i * 0.5, "sample", { i, -i } });
+    }
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(samples);
+    JSONDecoder decoder;
+    vector<Sample> decoded;
+    decoder.container(container.content).decodeTo(decoded);
+    const CodableStats& encoding = container.stats();
+    const CodableStats& decoding = decoder.stats();
+
+#ifdef CODABLE_ENABLE_STATS
+    //Every sample has 4 numbers (2 of them in array), closure, array and 4 fields: 1 + 100 * (1 + 4 + 2) containers
+    if (encoding.numbersWritten != 400 || encoding.bytesWritten != container.content.size() || encoding.contentTime == 0) {
+        cerr << "[Stats check]: encoding statistics are wrong: " << encoding.numbersWritten << " numbers, " << encoding.bytesWritten << " bytes\n";
+        return false;
+    }
+    if (decoding.bytesScanned != container.content.size() || decoding.nodesCreated != 701 || decoding.numbersParsed != 400 ||
+        decoding.keyLookups != 400 || decoding.keyProbes != 400 || decoding.allocations < decoding.nodesCreated ||
+        decoding.tokenizeTime == 0 || decoding.treeBuildTime == 0 || decoding.fieldDecodeTime == 0) {
+        cerr << "[Stats check]: decoding statistics are wrong: " << decoding.nodesCreated << " containers, " << decoding.keyLookups
+            << " lookups, " << decoding.keyProbes << " probes, " << decoding.numbersParsed << " numbers\n";
+        return false;
+    }
+    //Reversed order of keys needs more probes
+    decoder.resetStats();
+    JSONDecodeContainer reversed = decoder.container("{\"c\": 3, \"b\": 2, \"a\": 1}");
+    int a = 0, b = 0, c = 0;
+    reversed.decodeTo(a, "a");
+    reversed.decodeTo(b, "b");
+    reversed.decodeTo(c, "c");
+    if (decoder.stats().keyLookups != 3 || decoder.stats().keyProbes != 8) {
+        cerr << "[Stats check]: lookups of reversed keys are counted incorrectly: " << decoder.stats().keyProbes << " probes\n";
+        return false;
+    }
+#else
+    if (!check_zeros(encoding) || !check_zeros(decoding)) {
+        cerr << "[Stats check]: statistics are collected without CODABLE_ENABLE_STATS\n";
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool check_parallel() {
+    vector<Sample> samples;
+    for (int i = 0; i < 2000; i++) {
+        samples.push_back({ i, i * 0.5, "sample", { i, -i } });
+    }
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(samples);
+    CodableThreadPool pool(4);
+    JSONParallelDecoder parallel(&pool);
+    //Elements are decoded from parsed tree, then they are parsed by workers too
+    //(lazy elements are created by decoder and parsed again by workers: 1 + 2000 + 2000 * 7 containers)
+    for (bool lazy : { false, true }) {
+        JSONDecoder decoder;
+        decoder.setLazy(lazy);
+        vector<Sample> decoded;
+        JSONDecodeContainer array = decoder.container(container.content);
+        parallel.decodeTo(array, decoded);
+        const CodableStats& decoding = decoder.stats();
+#ifdef CODABLE_ENABLE_STATS
+        if (decoded.size() != samples.size() || decoding.keyLookups != 8000 || decoding.numbersParsed != 8000 ||
+            decoding.nodesCreated != (lazy ? 16001 : 14001) || decoding.fieldDecodeTime == 0) {
+            cerr << "[Stats check]: statistics of parallel decoding are wrong (lazy: " << lazy << "): " << decoding.nodesCreated
+                << " containers, " << decoding.keyLookups << " lookups, " << decoding.numbersParsed << " numbers\n";
+            return false;
+        }
+#else
+        if (!check_zeros(decoding)) {
+            cerr << "[Stats check]: statistics are collected without CODABLE_ENABLE_STATS\n";
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+//Sink that collects encoded text
+class StringSink: public CoderSink {
+public:
+    string text;
+
+    void write(const char* data, unsigned long length) {
+        text.append(data, length);
+    }
+};
+
+//Counters of pieces of parallel encoding are added to statistics of container
+bool check_parallel_encoding() {
+    vector<Sample> samples;
+    for (int i = 0; i < 2000; i++) {
+        samples.push_back({ i, i * 0.5, "sample", { i, -i } });
+    }
+    CodableThreadPool pool(4);
+    JSONParallelEncoder parallel(&pool);
+    JSONEncodeContainer container = JSONEncoder().container();
+    parallel.encode(container, samples);
+    StringSink sink;
+    JSONEncodeContainer sinkContainer = JSONEncoder().container(&sink);
+    parallel.encode(sinkContainer, samples);
+#ifdef CODABLE_ENABLE_STATS
+    for (const JSONEncodeContainer* encoded : { &container, &sinkContainer }) {
+        const CodableStats& encoding = encoded->stats();
+        if (encoding.numbersWritten != 8000 || encoding.bytesWritten != container.content.size() || encoding.contentTime == 0) {
+            cerr << "[Stats check]: statistics of parallel encoding are wrong: " << encoding.numbersWritten << " numbers, "
+                << encoding.bytesWritten << " bytes\n";
+            return false;
+        }
+    }
+#else
+    if (!check_zeros(container.stats()) || !check_zeros(sinkContainer.stats())) {
+        cerr << "[Stats check]: statistics are collected without CODABLE_ENABLE_STATS\n";
+        return false;
+    }
+#endif
+    return sink.text == container.content;
+}
+
+//Text of lines that is kept in content is counted once, however many times lines are flushed
+bool check_lines() {
+#ifdef CODABLE_ENABLE_STATS
+    JSONEncodeContainer container = JSONEncoder().container();
+    for (int i = 0; i < 100; i++) {
+        container.encodeLine(Sample({ i, i * 0.5, "sample", { i } }));
+        container.flushLines();
+    }
+    if (container.stats().bytesWritten != container.content.size() || container.stats().numbersWritten != 300) {
+        cerr << "[Stats check]: lines are counted incorrectly: " << container.stats().bytesWritten << " bytes of "
+            << container.content.size() << '\n';
+        return false;
+    }
+#endif
+    return true;
+}
+
+int main() {
+    if (!check_stats() || !check_parallel() || !check_parallel_encoding() || !check_lines()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+//Test of streaming decoder
+//Description: feeding encoded arrays by chunks of different sizes and comparing decoded elements with encoded ones.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONStream.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Message {
+public:
+    int id;
+    string text;
+    vector<int> values;
+
+    bool operator ==(const Message& message) const {
+        return id == message.id && text == message.text && values == message.values;
+    }
+
+    CODABLE_FIELDS(Message, id, text, values)
+};
+
+vector<Message> make_messages(int count) {
+    vector<Message> messages;
+    for (int i = 0; i < count; i++) {
+        Message message;
+        message.id = i * 1000 - 7;
+        //Structural characters, quotes and backslashes inside of strings
+        message.text = "message " + to_string(i) + (i % 2 ? " [with, {brackets}]: \"quoted\"" : "\\");
+        message.values = vector<int>(i % 5, i);
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+//Feeding text by chunks of specific size and collecting decoded elements
+template <class T>
+bool feed_by_chunks(const string& text, unsigned long chunkSize, vector<T>& decoded) {
+    decoded.clear();
+    JSONStreamDecoder<T> stream([&](T& value) {
+        decoded.push_back(value);
+    });
+    for (unsigned long start = 0; start < text.length(); start += chunkSize) {
+        if (!stream.feed(text.data() + start, min(chunkSize, text.length() - start))) {
+            return false;
+        }
+    }
+    return stream.finish();
+}
+
+bool check_messages() {
+    vector<Message> messages = make_messages(200), decoded;
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(messages);
+    const string& text = container.content;
+    for (unsigned long chunkSize : { 1UL, 3UL, 63UL, 64UL, 65UL, 1000UL, 16384UL }) {
+        if (!feed_by_chunks(text, chunkSize, decoded) || decoded != messages) {
+            cerr << "[Stream check]: messages are decoded incorrectly by chunks of " << chunkSize << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_numbers() {
+    //Numbers and whitespaces are split between chunks
+    const string text = " [ 1, 22 ,333,\n-4444, 5.5e1 ]\n";
+    const vector<int> reference = { 1, 22, 333, -4444, 55 };
+    vector<int> decoded;
+    for (unsigned long chunkSize : { 1UL, 2UL, 5UL, 100UL }) {
+        if (!feed_by_chunks(text, chunkSize, decoded) || decoded != reference) {
+            cerr << "[Stream check]: numbers are decoded incorrectly by chunks of " << chunkSize << '\n';
+            return false;
+        }
+    }
+    vector<int> empty;
+    if (!feed_by_chunks(string("[]"), 1, empty) || !empty.empty()) {
+        cerr << "[Stream check]: empty array is decoded incorrectly\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_early_elements() {
+    //Elements are passed to callback before the end of text
+    string text = "[";
+    for (int i = 0; i < 100; i++) {
+        text += (i ? "," : "") + to_string(i);
+    }
+    int count = 0;
+    JSONStreamDecoder<int> stream([&](int& value) {
+        count++;
+    });
+    stream.feed(text.data(), text.length());
+    if (count < 50 || stream.isFinished()) {
+        cerr << "[Stream check]: elements are not decoded before the end of text\n";
+        return false;
+    }
+    stream.feed("]", 1);
+    if (!stream.finish() || count != 100) {
+        cerr << "[Stream check]: elements are lost at the end of text\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_malformed() {
+    vector<int> decoded;
+    if (feed_by_chunks(string("{\"a\": [1, 2]}"), 4, decoded) || feed_by_chunks(string("[1, 2"), 2, decoded)
+        || feed_by_chunks(string("[1, 2}"), 2, decoded) || feed_by_chunks(string("[1] [2]"), 1, decoded)) {
+        cerr << "[Stream check]: malformed text is accepted\n";
+        return false;
+    }
+    return true;
+}
+
+class Archive {
+public:
+    vector<Message> messages;
+    int count;
+
+    CODABLE_FIELDS(Archive, messages, count)
+};
+
+//Reading range of elements and comparing it with reference
+template <class T>
+bool read_elements(JSONElements<T> elements, const vector<T>& reference) {
+    vector<T> decoded;
+    for (const T& element : elements) {
+        decoded.push_back(element);
+    }
+    return decoded == reference;
+}
+
+bool check_elements() {
+    Archive archive;
+    archive.messages = make_messages(300);
+    archive.count = 300;
+    JSONEncodeContainer encoded = JSONEncoder().container();
+    encoded.encode(archive);
+    const string& text = encoded.content;
+
+    //Elements of parsed array
+    JSONDecoder decoder;
+    JSONDecodeContainer container = decoder.container(text);
+    if (!read_elements(container.elements<Message>("messages"), archive.messages)) {
+        cerr << "[Stream check]: elements of parsed array are decoded incorrectly\n";
+        return false;
+    }
+
+    //Elements of array that isn't expanded, memory of decoder doesn't depend on count of them
+    Arena arena;
+    JSONDecoder shallowDecoder(&arena);
+    shallowDecoder.setMaxDepth(1);
+    JSONDecodeContainer shallow = shallowDecoder.container(text);
+    unsigned long capacity = arena.capacity();
+    if (!read_elements(shallow.elements<Message>("messages"), archive.messages) || shallow.decode(int(), "count") != 300
+        || arena.capacity() != capacity || shallow["messages"]->childrenCount != 0) {
+        cerr << "[Stream check]: elements of array that isn't expanded are decoded incorrectly\n";
+        return false;
+    }
+    if (!read_elements(shallow.elements<Message>("missing"), vector<Message>())) {
+        cerr << "[Stream check]: elements of missing array are decoded\n";
+        return false;
+    }
+
+    //Elements of array text
+    const string numbers = " [1, [2], 3 ,4]";
+    if (!read_elements(JSONElements<int>(numbers.data(), numbers.length()), vector<int>({ 1, 0, 3, 4 }))) {
+        cerr << "[Stream check]: elements of array text are decoded incorrectly\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check_messages() || !check_numbers() || !check_early_elements() || !check_malformed() || !check_elements()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+//Test of escaping and unescaping of JSON strings
+//Description: round trips of strings with control characters, quotes, backslashes and UTF-8, decoding of \u escapes
+//with surrogate pairs, replacing of invalid UTF-8, special characters at every position of blocks of SIMD scanning.
+
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONPlan.hpp"
+#include "JSONString.hpp"
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+class Note {
+public:
+    string title;
+    vector<string> lines;
+
+    CODABLE_FIELDS(Note, title, lines)
+};
+
+//Simple escaping of ASCII for comparison with fast one
+string reference_escape(const string& text) {
+    string result;
+    for (unsigned char c : text) {
+        if (c == '\"' || c == '\\') {
+            result += '\\';
+            result += (char)c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else if (c < 0x20) {
+            const char* digits = "0123456789abcdef";
+            result += "\\u00";
+            result += digits[c >> 4];
+            result += digits[c & 15];
+        } else {
+            result += (char)c;
+        }
+    }
+    return result;
+}
+
+bool check_escape() {
+    string escaped;
+    string text = string("a\"b\\c/\b\f\n\r\t") + '\x01' + '\x1f' + "\xc3\xa9\xe6\xb0\xb4\xf0\x9f\x98\x80";
+    if (!jsonEscape(text.data(), text.length(), escaped) ||
+        escaped != "a\\\"b\\\\c/\\b\\f\\n\\r\\t\\u0001\\u001f\xc3\xa9\xe6\xb0\xb4\xf0\x9f\x98\x80") {
+        cerr << "[Escape check]: wrong escaped text: " << escaped << '\n';
+        return false;
+    }
+    //Special characters at every position of several blocks, so both SIMD and scalar parts are used
+    const char specials[] = { '\"', '\\', '\n', '\x02', 'x' };
+    for (unsigned long length = 0; length < 70; length++) {
+        for (unsigned long position = 0; position < length; position++) {
+            for (char special : specials) {
+                string source(length, 'a');
+                source[position] = special;
+                escaped.clear();
+                jsonEscape(source.data(), source.length(), escaped);
+                string unescaped;
+                if (escaped != reference_escape(source) || !jsonUnescape(escaped.data(), escaped.length(), unescaped) || unescaped != source) {
+                    cerr << "[Escape check]: wrong round trip of length " << length << " at " << position << '\n';
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool check_unescape() {
+    const char* escaped = "\\u0041\\u00e9\\u6c34\\ud83d\\ude00\\/\\\"";
+    string text;
+    if (!jsonUnescape(escaped, strlen(escaped), text) || text != "A\xc3\xa9\xe6\xb0\xb4\xf0\x9f\x98\x80/\"") {
+        cerr << "[Unescape check]: wrong unescaped text: " << text << '\n';
+        return false;
+    }
+    //Lone surrogates are replaced, unknown and incomplete escapes are kept
+    const char* broken = "\\ud83dx\\ude00\\q\\u12";
+    text.clear();
+    if (jsonUnescape(broken, strlen(broken), text) || text != "\xef\xbf\xbdx\xef\xbf\xbd\\q\\u12") {
+        cerr << "[Unescape check]: wrong text of broken escapes: " << text << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool check_utf8() {
+    //Overlong form, surrogate, code point after U+10FFFF, truncated sequence and stray continuation byte
+    const char* invalid[] = { "\xc0\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe6\xb0", "\x80" };
+    for (const char* sequence : invalid) {
+        string source = string("ok ") + sequence + " ok";
+        string escaped, unescaped;
+        if (jsonEscape(source.data(), source.length(), escaped) || jsonUnescape(source.data(), source.length(), unescaped) ||
+            escaped.compare(0, 6, "ok \xef\xbf\xbd") != 0 || escaped != unescaped) {
+            cerr << "[UTF-8 check]: invalid sequence isn't replaced: " << escaped << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check_round_trip() {
+    Note note;
+    note.title = "Quote \"title\"\twith \\ backslash";
+    note.lines = { "line\nbreak", string("nul \0 inside", 12), "\xe6\xb0\xb4 water", "" };
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(note);
+    JSONDecoder decoder;
+    Note decoded = decoder.container(container.content).decode(Note());
+    if (decoded.title != note.title || decoded.lines != note.lines) {
+        cerr << "[Round trip check]: wrong decoded note: " << container.content << '\n';
+        return false;
+    }
+    Note planned;
+    JSONPlanDecoder planDecoder;
+    if (!planDecoder.decode(container.content, planned) || planned.title != note.title || planned.lines != note.lines) {
+        cerr << "[Round trip check]: wrong note of plan decoder\n";
+        return false;
+    }
+    //Keys are escaped too
+    JSONEncodeContainer keys = JSONEncoder().container();
+    keys.encode(1, "a\"b");
+    if (keys.content.find("\"a\\\"b\"") == string::npos) {
+        cerr << "[Round trip check]: key isn't escaped: " << keys.content << '\n';
+        return false;
+    }
+    return true;
+}
+
+class Named {
+public:
+    string name;
+    int n = 0;
+
+    CODABLE_FIELDS(Named, name, n)
+};
+
+//Keys with escapes are found by their unescaped form, in short closures and in closures with key index
+bool check_keys() {
+    for (int fields : { 2, 40 }) {
+        JSONEncodeContainer container = JSONEncoder().container();
+        map<string, int> values;
+        for (int i = 0; i < fields; i++) {
+            values["k" + to_string(i)] = i;
+        }
+        values["a\"b"] = 7;
+        container.encode(values);
+        JSONDecoder decoder;
+        int value = 0;
+        if (!decoder.container(container.content).decodeTo(value, "a\"b") || value != 7) {
+            cerr << "[Keys check]: escaped key isn't found in closure of " << fields << " fields: " << container.content << '\n';
+            return false;
+        }
+        string text = container.content;
+        text.insert(1, "\"na\\u006de\": 3,");
+        if (!decoder.container(text).decodeTo(value, "name") || value != 3) {
+            cerr << "[Keys check]: key with \\u escape isn't found in closure of " << fields << " fields\n";
+            return false;
+        }
+    }
+    Named named;
+    JSONPlanDecoder planDecoder;
+    if (!planDecoder.decode("{\"na\\u006de\": \"x\", \"n\": 5}", named) || named.name != "x" || named.n != 5) {
+        cerr << "[Keys check]: key with \\u escape isn't found by plan decoder\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check_escape() || !check_unescape() || !check_utf8() || !check_round_trip() || !check_keys()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+//Test of structural characters scanner
+//Description: comparing every supported SIMD implementation with simple character-by-character scan on random texts.
+
+#include "JSONStructural.hpp"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+//Reference scan: backslash escapes the next character anywhere, quotes that are not escaped open and close strings
+//Escaped structural characters outside of strings (that is malformed text) are still structural
+vector<unsigned> reference_scan(const string& text) {
+    vector<unsigned> positions;
+    bool inString = false, escaped = false;
+    for (unsigned i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (escaped) {
+            escaped = false;
+            if (c == '\"' || c == '\\') {
+                continue;
+            }
+        } else if (c == '\\') {
+            escaped = true;
+            continue;
+        }
+        if (c == '\"') {
+            inString = !inString;
+        } else if (!inString && string("{}[]:,").find(c) != string::npos) {
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+//Scanning text by pieces of specific size (multiple of 64)
+vector<unsigned> simd_scan(const string& text, JSONScanLevel level, unsigned long pieceSize) {
+    JSONStructuralScanner scanner(level);
+    vector<unsigned> positions, piece(pieceSize);
+    scanner.begin();
+    for (unsigned long start = 0; start < text.length(); start += pieceSize) {
+        unsigned long length = min(pieceSize, (unsigned long)text.length() - start);
+        unsigned long count = scanner.scan(text.data() + start, length, piece.data());
+        for (unsigned long i = 0; i < count; i++) {
+            positions.push_back(start + piece[i]);
+        }
+    }
+    return positions;
+}
+
+bool check_random_texts() {
+    //Alphabet with a lot of quotes and backslashes to get long sequences of them on block boundaries
+    const string alphabet = "\"\"\\\\\\{}[]:, a0\x1a\x0c;|";
+    const JSONScanLevel levels[] = { JSONScanLevel::scalar, JSONScanLevel::sse2, JSONScanLevel::avx2 };
+    mt19937 random(2024);
+    for (int i = 0; i < 3000; i++) {
+        string text;
+        unsigned long length = random() % 700;
+        for (unsigned long j = 0; j < length; j++) {
+            text += alphabet[random() % alphabet.length()];
+        }
+        vector<unsigned> reference = reference_scan(text);
+        for (JSONScanLevel level : levels) {
+            if (!jsonScanLevelSupported(level)) {
+                continue;
+            }
+            for (unsigned long pieceSize : { 64UL, 128UL, 1024UL }) {
+                if (simd_scan(text, level, pieceSize) != reference) {
+                    cerr << "[Structural check]: implementation " << (int)level << " failed with pieces of " << pieceSize << " on text: " << text << '\n';
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    if (!check_random_texts()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+//Test of types dispatched by their kinds
+//Description: round trips of integers of all sizes, enums, std::array, std::deque, std::vector<bool>, maps and optional
+//values through JSON (generic decoder and decode plans), binary format and CBOR, then checking of JSON text and ranges.
+
+#include "Binary.hpp"
+#include "CBOR.hpp"
+#include "Codable.hpp"
+#include "JSON.hpp"
+#include "JSONPlan.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+enum class Color : uint8_t {
+    red,
+    green,
+    blue = 200
+};
+
+enum Level {
+    low = -1,
+    high = 1
+};
+
+class Limits {
+public:
+    int8_t tiny = 0;
+    uint8_t byte = 0;
+    int16_t small = 0;
+    uint16_t word = 0;
+    unsigned count = 0;
+    unsigned long long big = 0;
+    long wide = 0;
+
+    bool operator ==(const Limits& limits) const {
+        return tiny == limits.tiny && byte == limits.byte && small == limits.small && word == limits.word &&
+            count == limits.count && big == limits.big && wide == limits.wide;
+    }
+
+    CODABLE_FIELDS(Limits, tiny, byte, small, word, count, big, wide)
+};
+
+class Palette {
+public:
+    Color main = Color::red;
+    Level level = low;
+    array<int, 3> rgb = {{ 0, 0, 0 }};
+    deque<string> names;
+    vector<bool> flags;
+    map<string, int> weights;
+    unordered_map<string, vector<Color>> groups;
+    unique_ptr<Limits> limits;
+    shared_ptr<string> comment;
+    unique_ptr<int> missing;
+
+    bool operator ==(const Palette& palette) const {
+        return main == palette.main && level == palette.level && rgb == palette.rgb && names == palette.names &&
+            flags == palette.flags && weights == palette.weights && groups == palette.groups &&
+            (limits == nullptr ? palette.limits == nullptr : palette.limits != nullptr && *limits == *palette.limits) &&
+            (comment == nullptr ? palette.comment == nullptr : palette.comment != nullptr && *comment == *palette.comment) &&
+            (missing == nullptr) == (palette.missing == nullptr);
+    }
+
+    CODABLE_FIELDS(Palette, main, level, rgb, names, flags, weights, groups, limits, comment, missing)
+};
+
+void make_palette(Palette& palette) {
+    palette.main = Color::blue;
+    palette.level = high;
+    palette.rgb = {{ 255, 128, -1 }};
+    palette.names = { "sky", "sea \"deep\"" };
+    palette.flags = { true, false, true };
+    palette.weights = { { "a", 1 }, { "b\n", -2 } };
+    palette.groups = { { "warm", { Color::red } }, { "cold", { Color::green, Color::blue } } };
+    palette.limits.reset(new Limits());
+    palette.limits->tiny = -128;
+    palette.limits->byte = 255;
+    palette.limits->small = -32768;
+    palette.limits->word = 65535;
+    palette.limits->count = 4294967295u;
+    palette.limits->big = 18446744073709551615ull;
+    palette.limits->wide = -9223372036854775807L - 1;
+    palette.comment = make_shared<string>("shared");
+}
+
+bool check_json() {
+    Palette palette, decoded, planned;
+    make_palette(palette);
+    JSONEncodeContainer container = JSONEncoder().container();
+    container.encode(palette);
+    JSONDecoder decoder;
+    decoder.container(container.content).decodeTo(decoded);
+    if (!(decoded == palette)) {
+        cerr << "[JSON check]: wrong decoded palette: " << container.content << '\n';
+        return false;
+    }
+    JSONPlanDecoder planDecoder;
+    if (!planDecoder.decode(container.content, planned) || !(planned == palette)) {
+        cerr << "[JSON check]: wrong palette of plan decoder\n";
+        return false;
+    }
+    const char* parts[] = { "\"main\": 200", "\"level\": 1", "\"rgb\": [255,128,-1]", "\"flags\": [true,false,true]",
+        "\"weights\": {\"a\": 1,\"b\\n\": -2}", "\"big\": 18446744073709551615", "\"missing\": null" };
+    for (const char* part : parts) {
+        if (container.content.find(part) == string::npos) {
+            cerr << "[JSON check]: text doesn't have " << part << ": " << container.content << '\n';
+            return false;
+        }
+    }
+    //Null clears optional value, values out of range and extra elements of std::array are skipped
+    decoder.container("{\"limits\": null, \"comment\": null, \"rgb\": [1, 2, 3, 4], \"main\": 300, \"level\": -1}").decodeTo(decoded);
+    if (decoded.limits != nullptr || decoded.comment != nullptr || decoded.rgb != array<int, 3>{{ 1, 2, 3 }} ||
+        decoded.main != Color::blue || decoded.level != low) {
+        cerr << "[JSON check]: wrong decoding of nulls and ranges\n";
+        return false;
+    }
+    Limits limits;
+    limits.byte = 7;
+    decoder.container("{\"byte\": 256, \"count\": -1, \"tiny\": 5}").decodeTo(limits);
+    if (limits.byte != 7 || limits.count != 0 || limits.tiny != 5) {
+        cerr << "[JSON check]: integers out of range are decoded\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_binary() {
+    Palette palette, decoded;
+    make_palette(palette);
+    BinaryEncodeContainer container = BinaryEncoder().container();
+    container.encode(palette);
+    BinaryDecoder decoder;
+    decoder.container(container.content).decodeTo(decoded);
+    if (!(decoded == palette)) {
+        cerr << "[Binary check]: wrong decoded palette\n";
+        return false;
+    }
+    return true;
+}
+
+bool check_cbor() {
+    Palette palette, decoded;
+    make_palette(palette);
+    CBOREncodeContainer container = CBOREncoder().container();
+    container.encode(palette);
+    CBORDecoder decoder;
+    decoder.container(container.content).decodeTo(decoded);
+    if (!(decoded == palette)) {
+        cerr << "[CBOR check]: wrong decoded palette\n";
+        return false;
+    }
+    //Map of two entries with definite length: {"a": 1, "b": null}
+    map<string, unique_ptr<int>> entries;
+    entries["a"].reset(new int(1));
+    entries["b"];
+    CBOREncodeContainer small = CBOREncoder().container();
+    small.encode(entries);
+    if (small.content != string("\xa2\x61" "a" "\x01\x61" "b" "\xf6", 7)) {
+        cerr << "[CBOR check]: wrong encoded map\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!check_json() || !check_binary() || !check_cbor()) {
+        return 1;
+    }
+    return 0;
+}